@@ -0,0 +1,332 @@
+﻿//  iml::containerと標準ライブラリの対応するコンテナの性能比較
+//  使い方 : container_benchmark [--format csv|json] [--max 要素数の上限(既定 10000000)]
+//  要素数10から10倍ずつ上限までの各要素数について,1操作あたりの時間(ns)を出力する
+//  tree_mapはイテレータによる走査とeraseが未完成のため,走査はfor_eachで測定しeraseは"skipped"として出力する
+
+#include <IMathLib/container/array.hpp>
+#include <IMathLib/container/list.hpp>
+#include <IMathLib/container/map.hpp>
+#include <IMathLib/container/queue.hpp>
+#include <IMathLib/container/stack.hpp>
+#include <IMathLib/bitset/bitset.hpp>
+
+#include <bitset>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <stack>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+namespace {
+
+	//  最適化による計算の除去を防ぐ
+	volatile size_t sink;
+
+	//  測定結果
+	struct result {
+		const char*	container;
+		const char*	impl;
+		const char*	op;
+		size_t		size;
+		double		ns_per_op;
+		bool		skipped;		//  実装の不備により測定しなかった
+	};
+	std::vector<result> results;
+
+	//  1回の計測を行う(戻り値は経過時間(ns))
+	template <class F>
+	double elapsed(F f) {
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::nano>(end - start).count();
+	}
+	//  要素数nに対する操作の計測回数(小さい要素数ほど繰り返して揺らぎを抑える)
+	size_t repeat(size_t n) {
+		size_t r = 1000000 / n;
+		return (r < 3) ? 3 : r;
+	}
+	//  trial()が1回の計測の経過時間を返すとき,その最小値をops操作あたりの時間として記録する
+	//  コピーやムーブの結果はtrial()の中で計測の外に保持して,破棄の時間を含めないようにする
+	template <class Trial>
+	void record(const char* container, const char* impl, const char* op, size_t n, size_t ops, Trial trial) {
+		double best = 0;
+		for (size_t i = 0, r = repeat(n); i < r; ++i) {
+			double t = trial();
+			if ((i == 0) || (t < best)) best = t;
+		}
+		results.push_back(result{ container, impl, op, n, best / ops, false });
+	}
+	//  測定しなかった操作も出力から欠けないように記録する
+	void record_skipped(const char* container, const char* impl, const char* op, size_t n) {
+		results.push_back(result{ container, impl, op, n, 0, true });
+	}
+	//  測定しない操作の指定
+	struct skip_op {};
+
+	//  [0, range)の乱数列
+	std::vector<int> random_keys(size_t count, size_t range, unsigned seed) {
+		std::mt19937 rng(seed);
+		std::vector<int> v(count);
+		for (auto& x : v) x = static_cast<int>(rng() % range);
+		return v;
+	}
+
+
+	//  dynamic_array / std::vector
+	template <class Array>
+	void bench_array(const char* impl, size_t n) {
+		const std::vector<int> keys = random_keys(n, n, 1);
+		record("dynamic_array", impl, "insert", n, n, [&] {
+			Array a;
+			return elapsed([&] { for (size_t i = 0; i < n; ++i) a.push_back(static_cast<int>(i)); });
+		});
+		record("dynamic_array", impl, "erase", n, n, [&] {
+			Array a;
+			for (size_t i = 0; i < n; ++i) a.push_back(static_cast<int>(i));
+			return elapsed([&] { for (size_t i = 0; i < n; ++i) a.pop_back(); });
+		});
+		Array a;
+		for (size_t i = 0; i < n; ++i) a.push_back(static_cast<int>(i));
+		record("dynamic_array", impl, "lookup", n, n, [&] {
+			return elapsed([&] { size_t s = 0; for (int k : keys) s += a[k]; sink = s; });
+		});
+		record("dynamic_array", impl, "iterate", n, n, [&] {
+			return elapsed([&] { size_t s = 0; for (int x : a) s += x; sink = s; });
+		});
+		record("dynamic_array", impl, "copy", n, n, [&] {
+			std::unique_ptr<Array> b;
+			return elapsed([&] { b.reset(new Array(a)); sink = b->size(); });
+		});
+		record("dynamic_array", impl, "move", n, 1, [&] {
+			Array b(a);
+			std::unique_ptr<Array> c;
+			return elapsed([&] { c.reset(new Array(std::move(b))); sink = c->size(); });
+		});
+	}
+	//  一括挿入/削除と1要素ずつの挿入/削除の比較(要素数nの配列の中央へk要素)
+	template <class Array>
+	void bench_array_range(const char* impl, size_t n, size_t k) {
+		Array a, src;
+		for (size_t i = 0; i < n; ++i) a.push_back(static_cast<int>(i));
+		for (size_t i = 0; i < k; ++i) src.push_back(static_cast<int>(i));
+		record("dynamic_array", impl, "insert_range_middle", n, k, [&] {
+			Array b(a);
+			return elapsed([&] { b.insert(b.begin() + n / 2, src.begin(), src.end()); });
+		});
+		record("dynamic_array", impl, "insert_single_middle", n, k, [&] {
+			Array b(a);
+			return elapsed([&] { for (size_t i = 0; i < k; ++i) b.insert(b.begin() + n / 2 + i, src[i]); });
+		});
+		record("dynamic_array", impl, "erase_range_middle", n, k, [&] {
+			Array b(a);
+			return elapsed([&] { b.erase(b.begin() + n / 2, b.begin() + n / 2 + k); });
+		});
+		record("dynamic_array", impl, "erase_single_middle", n, k, [&] {
+			Array b(a);
+			return elapsed([&] { for (size_t i = 0; i < k; ++i) b.erase(b.begin() + n / 2); });
+		});
+	}
+
+
+	//  list / std::list
+	template <class List>
+	void bench_list(const char* impl, size_t n) {
+		record("list", impl, "insert", n, n, [&] {
+			List l;
+			return elapsed([&] { for (size_t i = 0; i < n; ++i) l.push_back(static_cast<int>(i)); });
+		});
+		record("list", impl, "erase", n, n, [&] {
+			List l;
+			for (size_t i = 0; i < n; ++i) l.push_back(static_cast<int>(i));
+			return elapsed([&] { for (size_t i = 0; i < n; ++i) l.pop_front(); });
+		});
+		List l;
+		for (size_t i = 0; i < n; ++i) l.push_back(static_cast<int>(i));
+		//  線形探索のため探索回数は固定する
+		const std::vector<int> keys = random_keys(16, n, 2);
+		record("list", impl, "lookup", n, keys.size(), [&] {
+			return elapsed([&] {
+				size_t s = 0;
+				for (int k : keys)
+					for (int x : l) if (x == k) { s += x; break; }
+				sink = s;
+			});
+		});
+		record("list", impl, "iterate", n, n, [&] {
+			return elapsed([&] { size_t s = 0; for (int x : l) s += x; sink = s; });
+		});
+		record("list", impl, "copy", n, n, [&] {
+			std::unique_ptr<List> b;
+			return elapsed([&] { b.reset(new List(l)); sink = b->size(); });
+		});
+		record("list", impl, "move", n, 1, [&] {
+			List b(l), c;
+			return elapsed([&] { c = std::move(b); sink = c.size(); });
+		});
+	}
+
+
+	//  tree_map / std::map
+	//  erase:キーによる削除(skip_opのときは測定しない)
+	template <class Map, class Contains, class ForEach, class Erase>
+	void bench_map(const char* impl, size_t n, Contains contains, ForEach for_each, Erase erase) {
+		const std::vector<int> keys = random_keys(n, n, 3);
+		record("tree_map", impl, "insert", n, n, [&] {
+			Map m;
+			return elapsed([&] { for (int k : keys) m[k] = k; });
+		});
+		if constexpr (std::is_same_v<Erase, skip_op>) record_skipped("tree_map", impl, "erase", n);
+		else {
+			record("tree_map", impl, "erase", n, n, [&] {
+				Map m;
+				for (int k : keys) m[k] = k;
+				return elapsed([&] { for (int k : keys) erase(m, k); });
+			});
+		}
+		Map m;
+		for (int k : keys) m[k] = k;
+		const std::vector<int> queries = random_keys(n, n, 4);
+		record("tree_map", impl, "lookup", n, n, [&] {
+			return elapsed([&] { size_t s = 0; for (int k : queries) s += contains(m, k); sink = s; });
+		});
+		record("tree_map", impl, "iterate", n, m.size(), [&] {
+			return elapsed([&] { size_t s = 0; for_each(m, [&s](const auto& v) { s += v.second; }); sink = s; });
+		});
+		record("tree_map", impl, "copy", n, m.size(), [&] {
+			std::unique_ptr<Map> b;
+			return elapsed([&] { b.reset(new Map(m)); sink = b->size(); });
+		});
+		record("tree_map", impl, "move", n, 1, [&] {
+			Map b(m);
+			std::unique_ptr<Map> c;
+			return elapsed([&] { c.reset(new Map(std::move(b))); sink = c->size(); });
+		});
+	}
+
+
+	//  queue / std::queue
+	template <class Queue, class Push, class Pop>
+	void bench_queue(const char* container, const char* impl, size_t n, Push push, Pop pop) {
+		record(container, impl, "insert", n, n, [&] {
+			Queue q;
+			return elapsed([&] { for (size_t i = 0; i < n; ++i) push(q, static_cast<int>(i)); });
+		});
+		record(container, impl, "erase", n, n, [&] {
+			Queue q;
+			for (size_t i = 0; i < n; ++i) push(q, static_cast<int>(i));
+			return elapsed([&] { for (size_t i = 0; i < n; ++i) pop(q); });
+		});
+		Queue q;
+		for (size_t i = 0; i < n; ++i) push(q, static_cast<int>(i));
+		record(container, impl, "copy", n, n, [&] {
+			std::unique_ptr<Queue> b;
+			return elapsed([&] { b.reset(new Queue(q)); sink = b->size(); });
+		});
+		record(container, impl, "move", n, 1, [&] {
+			Queue b(q);
+			std::unique_ptr<Queue> c;
+			return elapsed([&] { c.reset(new Queue(std::move(b))); sink = c->size(); });
+		});
+	}
+
+
+	//  bitset / std::bitset
+	template <size_t N>
+	void bench_bitset() {
+		std::unique_ptr<iml::bitset<N>> a(new iml::bitset<N>());
+		std::unique_ptr<std::bitset<N>> b(new std::bitset<N>());
+		const std::vector<int> keys = random_keys(N, N, 5);
+		record("bitset", "iml", "insert", N, N, [&] { return elapsed([&] { for (int k : keys) a->set(k); }); });
+		record("bitset", "std", "insert", N, N, [&] { return elapsed([&] { for (int k : keys) b->set(k); }); });
+		record("bitset", "iml", "erase", N, N, [&] { return elapsed([&] { for (int k : keys) a->set(k, false); }); });
+		record("bitset", "std", "erase", N, N, [&] { return elapsed([&] { for (int k : keys) b->reset(k); }); });
+		for (size_t i = 0; i < N; i += 3) { a->set(i); b->set(i); }
+		record("bitset", "iml", "lookup", N, N, [&] { return elapsed([&] { size_t s = 0; for (int k : keys) s += a->bit(k); sink = s; }); });
+		record("bitset", "std", "lookup", N, N, [&] { return elapsed([&] { size_t s = 0; for (int k : keys) s += (*b)[k]; sink = s; }); });
+		record("bitset", "iml", "count", N, N, [&] { return elapsed([&] { sink = a->count(); }); });
+		record("bitset", "std", "count", N, N, [&] { return elapsed([&] { sink = b->count(); }); });
+		record("bitset", "iml", "copy", N, N, [&] {
+			return elapsed([&] { std::unique_ptr<iml::bitset<N>> c(new iml::bitset<N>(*a)); sink = c->bit(0); });
+		});
+		record("bitset", "std", "copy", N, N, [&] {
+			return elapsed([&] { std::unique_ptr<std::bitset<N>> c(new std::bitset<N>(*b)); sink = (*c)[0]; });
+		});
+	}
+	template <size_t N>
+	void bench_bitset_upto(size_t max) {
+		if (N > max) return;
+		bench_bitset<N>();
+		if constexpr (N < 10000000) bench_bitset_upto<N * 10>(max);
+	}
+
+
+	void print_csv() {
+		std::printf("container,impl,op,size,ns_per_op\n");
+		for (const auto& r : results) {
+			if (r.skipped) std::printf("%s,%s,%s,%zu,skipped\n", r.container, r.impl, r.op, r.size);
+			else std::printf("%s,%s,%s,%zu,%.3f\n", r.container, r.impl, r.op, r.size, r.ns_per_op);
+		}
+	}
+	void print_json() {
+		std::printf("[\n");
+		for (size_t i = 0; i < results.size(); ++i) {
+			const auto& r = results[i];
+			const char* sep = (i + 1 == results.size()) ? "" : ",";
+			if (r.skipped) std::printf("  {\"container\": \"%s\", \"impl\": \"%s\", \"op\": \"%s\", \"size\": %zu, \"ns_per_op\": null, \"skipped\": true}%s\n"
+				, r.container, r.impl, r.op, r.size, sep);
+			else std::printf("  {\"container\": \"%s\", \"impl\": \"%s\", \"op\": \"%s\", \"size\": %zu, \"ns_per_op\": %.3f}%s\n"
+				, r.container, r.impl, r.op, r.size, r.ns_per_op, sep);
+		}
+		std::printf("]\n");
+	}
+}
+
+
+int main(int argc, char* argv[]) {
+	bool json = false;
+	size_t max = 10000000;
+	for (int i = 1; i < argc; ++i) {
+		if ((std::strcmp(argv[i], "--format") == 0) && (i + 1 < argc)) json = (std::strcmp(argv[++i], "json") == 0);
+		else if ((std::strcmp(argv[i], "--max") == 0) && (i + 1 < argc)) max = std::stoul(argv[++i]);
+		else {
+			std::fprintf(stderr, "usage: %s [--format csv|json] [--max N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	auto map_contains = [](auto& m, int k) { return m.find(k) != nullptr; };
+	auto std_map_contains = [](auto& m, int k) { return m.find(k) != m.end(); };
+	auto map_for_each = [](const auto& m, auto f) { m.for_each(f); };
+	auto std_map_for_each = [](const auto& m, auto f) { for (const auto& v : m) f(v); };
+	for (size_t n = 10; n <= max; n *= 10) {
+		bench_array<iml::dynamic_array<int>>("iml", n);
+		bench_array<std::vector<int>>("std", n);
+		bench_list<iml::list<int>>("iml", n);
+		bench_list<std::list<int>>("std", n);
+		bench_map<iml::tree_map<int, int>>("iml", n, map_contains, map_for_each, skip_op());
+		bench_map<std::map<int, int>>("std", n, std_map_contains, std_map_for_each, [](auto& m, int k) { m.erase(k); });
+		bench_queue<iml::queue<int>>("queue", "iml", n, [](auto& q, int v) { q.enqueue(v); }, [](auto& q) { q.dequeue(); });
+		bench_queue<std::queue<int>>("queue", "std", n, [](auto& q, int v) { q.push(v); }, [](auto& q) { q.pop(); });
+		bench_queue<iml::stack<int>>("stack", "iml", n, [](auto& s, int v) { s.push(v); }, [](auto& s) { s.pop(); });
+		bench_queue<std::stack<int>>("stack", "std", n, [](auto& s, int v) { s.push(v); }, [](auto& s) { s.pop(); });
+	}
+	//  1000000要素の配列の中央への1000要素の一括挿入/削除と1要素ずつの挿入/削除
+	if (max >= 1000000) {
+		bench_array_range<iml::dynamic_array<int>>("iml", 1000000, 1000);
+		bench_array_range<std::vector<int>>("std", 1000000, 1000);
+	}
+	bench_bitset_upto<10>(max);
+
+	if (json) print_json();
+	else print_csv();
+	return 0;
+}
\ No newline at end of file
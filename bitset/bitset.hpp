@@ -4,21 +4,42 @@
 #include "IMathLib/IMathLib_config.hpp"
 #include "IMathLib/string/string.hpp"
 #include "IMathLib/math/math.hpp"
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace iml {
 
-	//ビットセットクラス
+	//64bit整数の1の数
+	inline size_t popcount(uint64_t n) noexcept {
+#if defined(_MSC_VER) && defined(_M_X64)
+		return static_cast<size_t>(__popcnt64(n));
+#elif defined(__GNUC__)
+		return static_cast<size_t>(__builtin_popcountll(n));
+#else
+		//ビットの並列加算
+		n = n - ((n >> 1) & 0x5555555555555555ull);
+		n = (n & 0x3333333333333333ull) + ((n >> 2) & 0x3333333333333333ull);
+		n = (n + (n >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+		return static_cast<size_t>((n * 0x0101010101010101ull) >> 56);
+#endif
+	}
+
+	//ビットセットクラス(64bit単位で格納して演算も64bit単位で行う)
 	template <size_t N>
 	class bitset {
 		template <size_t> friend class bitset;
 
-		static constexpr size_t	array_size = ((N - 1) >> 3) + 1;
-		unsigned char				x[array_size];
+		using word_type = uint64_t;
+		static constexpr size_t	word_bits = 64;
+		static constexpr size_t	array_size = ((N - 1) >> 6) + 1;
+		word_type				x[array_size];
 
-		//最上位バイトに対してビットマスクを作用させてN桁分以外は0クリア
+		//最上位の語に対してビットマスクを作用させてN桁分以外は0クリア
 		bitset& byte_check() {
-			//8の倍数のときは除外
-			if ((N & 7) != 0) x[array_size - 1] &= (1 << (N & 7)) - 1;
+			//64の倍数のときは除外
+			if ((N & 63) != 0) x[array_size - 1] &= (word_type(1) << (N & 63)) - 1;
 			return *this;
 		}
 	public:
@@ -29,79 +50,18 @@ namespace iml {
 		template <size_t N2>
 		bitset(const bitset<N2>& b) : x{} {
 			for (size_t i = 0, n = (min)(this->array_size, b.array_size); i < n; ++i) this->x[i] = b.x[i];
+			byte_check();
 		}
 		bitset(size_t n) :x{} {
-			//全てを場合分けして定義
-			switch (array_size) {
-			case 1:
-				x[0] = static_cast<unsigned char>(n & 0xFF);
-				break;
-			case 2:
-				x[0] = static_cast<unsigned char>(n & 0xFF);
-				x[1] = static_cast<unsigned char>((n & (0xFF << 8)) >> 8);
-				break;
-			case 3:
-				x[0] = static_cast<unsigned char>(n & 0xFF);
-				x[1] = static_cast<unsigned char>((n & (0xFF << 8)) >> 8);
-				x[2] = static_cast<unsigned char>((n & (0xFF << 16)) >> 16);
-				break;
-				//64bitの場合はさらに場合分けを与える
-#if defined _IMATH_INT_64BIT_
-			case 4:
-				x[0] = static_cast<unsigned char>(n & 0xFF);
-				x[1] = static_cast<unsigned char>((n & (0xFF << 8)) >> 8);
-				x[2] = static_cast<unsigned char>((n & (0xFF << 16)) >> 16);
-				x[3] = static_cast<unsigned char>((n & (0xFF << 24)) >> 24);
-				break;
-			case 5:
-				x[0] = static_cast<unsigned char>(n & 0xFF);
-				x[1] = static_cast<unsigned char>((n & (0xFF << 8)) >> 8);
-				x[2] = static_cast<unsigned char>((n & (0xFF << 16)) >> 16);
-				x[3] = static_cast<unsigned char>((n & (0xFF << 24)) >> 24);
-				x[4] = static_cast<unsigned char>((n & (0xFF << 32)) >> 32);
-				break;
-			case 6:
-				x[0] = static_cast<unsigned char>(n & 0xFF);
-				x[1] = static_cast<unsigned char>((n & (0xFF << 8)) >> 8);
-				x[2] = static_cast<unsigned char>((n & (0xFF << 16)) >> 16);
-				x[3] = static_cast<unsigned char>((n & (0xFF << 24)) >> 24);
-				x[4] = static_cast<unsigned char>((n & (0xFF << 32)) >> 32);
-				x[5] = static_cast<unsigned char>((n & (0xFF << 40)) >> 40);
-				break;
-			case 7:
-				x[0] = static_cast<unsigned char>(n & 0xFF);
-				x[1] = static_cast<unsigned char>((n & (0xFF << 8)) >> 8);
-				x[2] = static_cast<unsigned char>((n & (0xFF << 16)) >> 16);
-				x[3] = static_cast<unsigned char>((n & (0xFF << 24)) >> 24);
-				x[4] = static_cast<unsigned char>((n & (0xFF << 32)) >> 32);
-				x[5] = static_cast<unsigned char>((n & (0xFF << 40)) >> 40);
-				x[6] = static_cast<unsigned char>((n & (0xFF << 48)) >> 48);
-				break;
-#endif
-			default:
-				x[0] = static_cast<unsigned char>(n & 0xFF);
-				x[1] = static_cast<unsigned char>((n & (0xFF << 8)) >> 8);
-				x[2] = static_cast<unsigned char>((n & (0xFF << 16)) >> 16);
-				x[3] = static_cast<unsigned char>((n & (0xFF << 24)) >> 24);
-#if defined _IMATH_INT_64BIT_
-				x[4] = static_cast<unsigned char>((n & (0xFF << 32)) >> 32);
-				x[5] = static_cast<unsigned char>((n & (0xFF << 40)) >> 40);
-				x[6] = static_cast<unsigned char>((n & (0xFF << 48)) >> 48);
-				x[7] = static_cast<unsigned char>((n & (0xFF << 56)) >> 56);
-#endif
-			}
+			x[0] = static_cast<word_type>(n);
 			byte_check();
 		}
 		template <class CharT, class Predicate, class Allocator>
 		explicit bitset(const string<CharT, Predicate, Allocator>& str) :x{} {
-			for (size_t i = 0; i < array_size; ++i) {
-				for (size_t j = 0; j < 8; ++j) {
-					if (str.size() - 2 - ((i << 3) + j) < 0) x[i] &= ((1 << j) - 1);
-					else if (str[str.size() - 2 - ((i << 3) + j)] == '1') x[i] |= (1 << j);
-					else if (str[str.size() - 2 - ((i << 3) + j)] == '0') x[i] &= ~(1 << j);
-				}
+			//末尾(終端文字の直前)が最下位ビット
+			for (size_t i = 0; (i < N) && (i + 2 <= str.size()); ++i) {
+				if (str[str.size() - 2 - i] == '1') x[i >> 6] |= word_type(1) << (i & 63);
 			}
-			byte_check();
 		}
 		~bitset() {}
 
@@ -114,42 +74,42 @@ namespace iml {
 		//代入演算子
 		bitset& operator=(const bitset& b) {
 			for (size_t i = 0; i < array_size; ++i) this->x[i] = b.x[i];
+			return *this;
 		}
 		bitset& operator&=(const bitset& b) {
 			for (size_t i = 0; i < array_size; ++i) this->x[i] &= b.x[i];
+			return *this;
 		}
 		bitset& operator|=(const bitset& b) {
 			for (size_t i = 0; i < array_size; ++i) this->x[i] |= b.x[i];
+			return *this;
 		}
 		bitset& operator^=(const bitset& b) {
 			for (size_t i = 0; i < array_size; ++i) this->x[i] ^= b.x[i];
+			return *this;
 		}
 		bitset& operator<<=(size_t pos) {
-			size_t surplus = pos & 7;		//余るサイズ
-			size_t shift = pos >> 3;		//シフトで飛び越える配列の量
-			//surplus分のシフト
-			for (size_t i = 1; i <= array_size; ++i) {
-				x[array_size - i] <<= surplus;
-				//下の配列から持ってくる
-				if (array_size != i) x[array_size - i] |= (x[array_size - 1 - i] >> (8 - surplus));
+			if (pos >= N) return reset();
+			size_t surplus = pos & 63;		//余るサイズ
+			size_t shift = pos >> 6;		//シフトで飛び越える配列の量
+			//上位から順にshift分ずらした位置の語と1つ下の語から構成する
+			for (size_t i = array_size; i-- > shift;) {
+				x[i] = x[i - shift] << surplus;
+				if ((surplus != 0) && (i > shift)) x[i] |= x[i - shift - 1] >> (word_bits - surplus);
 			}
-			//shift分コピー
-			for (size_t i = 1; array_size >= i + shift; ++i) x[array_size - i] = x[array_size - i - shift];
 			//0クリア
 			for (size_t i = 0; i < shift; ++i) x[i] = 0;
 			return byte_check();
 		}
 		bitset& operator>>=(size_t pos) {
-			size_t surplus = pos & 7;		//余るサイズ
-			size_t shift = pos >> 3;		//シフトで飛び越える配列の量
-			//surplus分のシフト
-			for (size_t i = 0; i < array_size; ++i) {
-				x[i] >>= surplus;
-				//上の配列から持ってくる
-				if (i + 1 != array_size) x[i] |= (x[i + 1] << (8 - surplus));
+			if (pos >= N) return reset();
+			size_t surplus = pos & 63;		//余るサイズ
+			size_t shift = pos >> 6;		//シフトで飛び越える配列の量
+			//下位から順にshift分ずらした位置の語と1つ上の語から構成する
+			for (size_t i = 0; i + shift < array_size; ++i) {
+				x[i] = x[i + shift] >> surplus;
+				if ((surplus != 0) && (i + shift + 1 < array_size)) x[i] |= x[i + shift + 1] << (word_bits - surplus);
 			}
-			//shift分コピー
-			for (size_t i = 0; i + shift < array_size; ++i) x[i] = x[i + shift];
 			//全て消える配列
 			for (size_t i = 1; i <= shift; ++i) x[array_size - i] = 0;
 			return *this;
@@ -160,15 +120,15 @@ namespace iml {
 			return true;
 		}
 		bool operator!=(const bitset& b) const {
-			return (*this == b);
+			return !(*this == b);
 		}
 
 		constexpr size_t size() const noexcept { return N; }
 		//先頭から任意バイト目を取得
-		unsigned char byte(size_t n) const { return x[n]; }
+		unsigned char byte(size_t n) const { return static_cast<unsigned char>(x[n >> 3] >> ((n & 7) << 3)); }
 		//先頭から任意ビット目を取得
-		bool operator[](size_t pos) const { return (x[pos >> 3] & (1 << (pos & 7))) > 0; }
-		bool bit(size_t pos) const { return (x[pos >> 3] & (1 << (pos & 7))) > 0; }
+		bool operator[](size_t pos) const { return ((x[pos >> 6] >> (pos & 63)) & 1) != 0; }
+		bool bit(size_t pos) const { return ((x[pos >> 6] >> (pos & 63)) & 1) != 0; }
 
 		//リセット
 		bitset& reset() {
@@ -177,13 +137,13 @@ namespace iml {
 		}
 		//ビットのセット
 		bitset& set() {
-			for (size_t i = 0; i < array_size; ++i) x[i] = 0xFF;
+			for (size_t i = 0; i < array_size; ++i) x[i] = ~word_type(0);
 			return byte_check();
 		}
 		bitset& set(size_t pos, bool flag = true) {
 			if (pos >= N) return *this;
-			if(flag) x[pos >> 3] |= (1 << (pos & 7));
-			else x[pos >> 3] &= ~(1 << (pos & 7));
+			if(flag) x[pos >> 6] |= word_type(1) << (pos & 63);
+			else x[pos >> 6] &= ~(word_type(1) << (pos & 63));
 			return *this;
 		}
 		//ビットの反転
@@ -194,55 +154,27 @@ namespace iml {
 		//ビットの反転
 		bitset& flip(size_t pos) {
 			if (pos >= N) return *this;
-			x[pos >> 3] ^= (1 << (pos & 7));
+			x[pos >> 6] ^= word_type(1) << (pos & 63);
 			return *this;
 		}
 
+		//整数への変換(下位32bit)
+		size_t to_uint() const { return static_cast<size_t>(x[0] & 0xFFFFFFFFull); }
 		//整数への変換
-		size_t to_uint() const {
-			size_t result = 0;
-			for (size_t i = 0, n = (min<size_t>)(4, array_size); i < n; ++i) result |= x[i] << (8 * i);
-			return result;
-		}
-		//整数への変換
-		unsigned long to_ulong() const {
-			size_t result = 0;
-			for (size_t i = 0, n = (min<size_t>)(8, array_size); i < n; ++i) result |= x[i] << (8 * i);
-			return result;
-		}
+		unsigned long to_ulong() const { return static_cast<unsigned long>(x[0]); }
 		//文字列への変換
 		template <class CharT, class Predicate = type_comparison<CharT>, class Allocator = allocator<CharT, array_iterator<CharT>>>
 		string<CharT, Predicate, Allocator> to_string() const {
 			string<CharT, Predicate, Allocator> result;
 			result.reserve(N + 1);
-			//最初はN桁分の確保によるビットのズレの分
-			{
-				unsigned char temp = x[array_size - 1];
-				//Nが8の倍数とで分岐
-				if ((N & 7) != 0) {
-					for (size_t j = 9 - (N & 7); j <= 8; ++j)
-						result.push_back(((temp & (1 << (8 - j))) > 0) ? '1' : '0');
-				}
-				else {
-					for (size_t j = 1; j <= 8; ++j)
-						result.push_back(((temp & (1 << (8 - j))) > 0) ? '1' : '0');
-				}
-			}
-			for (size_t i = 2; i <= array_size; ++i) {
-				unsigned char temp = x[array_size - i];
-				for (size_t j = 1; j <= 8; ++j)
-					result.push_back(((temp & (1 << (8 - j))) > 0) ? '1' : '0');
-			}
+			//最上位ビットから順に出力
+			for (size_t i = N; i-- > 0;) result.push_back(bit(i) ? '1' : '0');
 			return result;
 		}
 		//1の数のカウント
 		size_t count() const {
 			size_t  result = 0;
-			for (size_t i = 0; i < array_size; ++i) {
-				unsigned char temp = x[i];
-				for (size_t j = 0; j < 8; ++j)
-					result += (temp & (1 << j)) > 0;
-			}
+			for (size_t i = 0; i < array_size; ++i) result += popcount(x[i]);
 			return result;
 		}
 	};
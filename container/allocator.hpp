@@ -4,11 +4,19 @@
 #include "IMathLib/utility/iterator.hpp"
 #include "IMathLib/utility/functional.hpp"
 #include "IMathLib/math/math/numeric_traits.hpp"
+#include <cstring>
+#include <new>
 
 
 // コンテナ等で用いるためのアロケータの実装
 namespace iml {
 
+	//  連続したメモリ領域を指すイテレータであるか(コンテナ側で特殊化する)
+	template <class T>
+	struct is_contiguous_iterator : is_pointer<T> {};
+	template <class T>
+	constexpr bool is_contiguous_iterator_v = is_contiguous_iterator<T>::value;
+
 	//  allocator_traitsのための補助
 	namespace alloc {
 		//  allocatorにpointerが存在
@@ -128,6 +136,74 @@ namespace iml {
 		struct Select_on_container_copy_construction<Allocator, false> {
 			static constexpr Allocator select_on_container_copy_construction(const Allocator&) { return Allocator(); }
 		};
+
+		//  expand()が存在するならそれを呼び出す
+		template <class Allocator, class Pointer>
+		struct is_exist_expand {
+		private:
+			template <class UAlloc> static auto tester(UAlloc*) ->decltype(declval<UAlloc>().expand(declval<Pointer>(), declval<size_t>(), declval<size_t>()), true_type());
+			template <class UAlloc> static false_type tester(...);
+		public:
+			static constexpr bool value = decltype(tester<Allocator>(nullptr))::value;
+		};
+		template <class Allocator, class Pointer, bool = is_exist_expand<Allocator, Pointer>::value>
+		struct Expand {
+			static bool expand(Allocator& a, Pointer p, size_t n, size_t size) { return a.expand(p, n, size); }
+		};
+		template <class Allocator, class Pointer>
+		struct Expand<Allocator, Pointer, false> {
+			static bool expand(Allocator&, Pointer, size_t, size_t) { return false; }
+		};
+
+		//  allocatorにalignmentが存在
+		template <class, class = void>
+		struct is_exist_alignment : false_type {};
+		template <class T>
+		struct is_exist_alignment<T, void_t<decltype(T::alignment)>> : true_type {};
+		template <class Allocator, class T, bool = is_exist_alignment<Allocator>::value>
+		struct alignment {
+			static constexpr size_t value = Allocator::alignment;
+		};
+		template <class Allocator, class T>
+		struct alignment<Allocator, T, false> {
+			static constexpr size_t value = alignof(T);
+		};
+
+		//  Alignに整列されたsizeバイトの確保と解放(既定の整列より大きいときのみ整列指定のnewを用いる)
+		template <size_t Align>
+		inline void* aligned_new(size_t size) {
+			if constexpr (Align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator new(size, std::align_val_t(Align));
+			else return ::operator new(size);
+		}
+		template <size_t Align>
+		inline void aligned_delete(void* p) noexcept {
+			if constexpr (Align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(p, std::align_val_t(Align));
+			else ::operator delete(p);
+		}
+
+		//  イテレータの指す要素の型
+		template <class Iterator>
+		using iterator_value_t = remove_cv_t<remove_reference_t<decltype(*declval<Iterator>())>>;
+		//  [first1, last1)に対して[first2, last2)のArgによる構築をmemcpyで一括して行えるか
+		template <class Allocator, class Iterator1, class Iterator2, class Arg>
+		struct is_bulk_copyable {
+			static constexpr bool value = is_contiguous_iterator_v<Iterator1> && is_contiguous_iterator_v<Iterator2>
+				&& is_same_v<iterator_value_t<Iterator1>, iterator_value_t<Iterator2>> && is_trivially_copyable_v<iterator_value_t<Iterator1>>
+				&& !is_exist_construct<Allocator, iterator_value_t<Iterator1>, type_tuple<Arg>>::value;
+		};
+		//  [first, last)に対するデフォルトコンストラクタの適用を一括して行えるか
+		template <class Allocator, class Iterator>
+		struct is_bulk_default_constructible {
+			static constexpr bool value = is_contiguous_iterator_v<Iterator>
+				&& is_trivially_default_constructible_v<iterator_value_t<Iterator>> && is_trivially_copyable_v<iterator_value_t<Iterator>>
+				&& !is_exist_construct<Allocator, iterator_value_t<Iterator>, type_tuple<>>::value;
+		};
+		//  [first, last)に対するデストラクタの適用を省略できるか
+		template <class Allocator, class Iterator>
+		struct is_trivially_destroyable {
+			static constexpr bool value = is_trivially_destructible_v<iterator_value_t<Iterator>>
+				&& !is_exist_destroy<Allocator, iterator_value_t<Iterator>>::value;
+		};
 	}
 
 
@@ -139,6 +215,9 @@ namespace iml {
 		using difference_type = typename alloc::difference_type<Allocator, typename pointer_traits<pointer>::difference_type>::type;
 		using size_type = typename alloc::size_type<Allocator, make_unsigned_t<difference_type>>::type;
 
+		//  allocateにより確保される領域の整列の保証
+		static constexpr size_t alignment = alloc::alignment<Allocator, value_type>::value;
+
 
 		template <class Other>
 		using rebind = typename Allocator::template rebind<Other>;
@@ -164,30 +243,79 @@ namespace iml {
 			//  入力イテレータでなければならない
 			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
 
-			while (first != last) construct(a, to_address(first++), forward<Types>(args)...);
+			if constexpr ((sizeof...(Types) == 0) && alloc::is_bulk_default_constructible<allocator_type, InputIterator>::value) {
+				using value_t = alloc::iterator_value_t<InputIterator>;
+				if (first == last) return;
+				//  算術型とポインタはゼロ初期化がビット列の0埋めと一致する
+				if constexpr (is_arithmetic_v<value_t> || is_pointer_v<value_t>) std::memset(to_address(first), 0, (last - first) * sizeof(value_t));
+				else {
+					const value_t temp = value_t();
+					for (value_t* p = to_address(first), *p_last = p + (last - first); p != p_last; ++p) std::memcpy(p, addressof(temp), sizeof(value_t));
+				}
+			}
+			else while (first != last) construct(a, to_address(first++), forward<Types>(args)...);
 		}
 		template <class InputIterator1, class InputIterator2>
 		static constexpr void copy_construct(allocator_type& a, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2) {
 			//  入力イテレータでなければならない
 			static_assert(is_iterator_v<InputIterator1, input_iterator_tag> && is_iterator_v<InputIterator2, input_iterator_tag>, "The type of iterator is different.");
 
-			while (first1 != last1) {
-				if (first2 == last2) break;
-				construct(a, to_address(first1++), *to_address(first2++));
+			//  トリビアルにコピー可能な型の連続領域はmemcpyで一括してコピーする
+			if constexpr (alloc::is_bulk_copyable<allocator_type, InputIterator1, InputIterator2, decltype(*declval<InputIterator2>())>::value) {
+				auto n = (iml::min)(last1 - first1, static_cast<decltype(last1 - first1)>(last2 - first2));
+				if (n > 0) std::memcpy(to_address(first1), to_address(first2), n * sizeof(alloc::iterator_value_t<InputIterator1>));
+				first1 += n;
+			}
+			else {
+				while (first1 != last1) {
+					if (first2 == last2) break;
+					construct(a, to_address(first1++), *to_address(first2++));
+				}
 			}
 			//  足りない部分はデフォルトコンストラクタを適用する
-			while (first1 != last1) construct(a, to_address(first1++));
+			construct_all(a, first1, last1);
 		}
 		template <class InputIterator1, class InputIterator2>
 		static constexpr void move_construct(allocator_type& a, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2) {
 			//  入力イテレータでなければならない
 			static_assert(is_iterator_v<InputIterator1, input_iterator_tag> && is_iterator_v<InputIterator2, input_iterator_tag>, "The type of iterator is different.");
 
-			while (first1 != last1) {
-				if (first2 == last2) break;
-				construct(a, to_address(first1++), move(*to_address(first2++)));
+			if constexpr (alloc::is_bulk_copyable<allocator_type, InputIterator1, InputIterator2, decltype(move(*declval<InputIterator2>()))>::value) {
+				auto n = (iml::min)(last1 - first1, static_cast<decltype(last1 - first1)>(last2 - first2));
+				if (n > 0) std::memcpy(to_address(first1), to_address(first2), n * sizeof(alloc::iterator_value_t<InputIterator1>));
+				first1 += n;
+			}
+			else {
+				while (first1 != last1) {
+					if (first2 == last2) break;
+					construct(a, to_address(first1++), move(*to_address(first2++)));
+				}
 			}
-			while (first1 != last1) construct(a, to_address(first1++));
+			construct_all(a, first1, last1);
+		}
+		//  ムーブコンストラクタが例外を送出し得るならばコピーによって構築する(再確保による要素の移し替えのため)
+		template <class InputIterator1, class InputIterator2>
+		static constexpr void move_if_noexcept_construct(allocator_type& a, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2) {
+			//  入力イテレータでなければならない
+			static_assert(is_iterator_v<InputIterator1, input_iterator_tag> && is_iterator_v<InputIterator2, input_iterator_tag>, "The type of iterator is different.");
+
+			using value_t = alloc::iterator_value_t<InputIterator2>;
+			if constexpr (alloc::is_bulk_copyable<allocator_type, InputIterator1, InputIterator2, decltype(*declval<InputIterator2>())>::value) {
+				auto n = (iml::min)(last1 - first1, static_cast<decltype(last1 - first1)>(last2 - first2));
+				if (n > 0) std::memcpy(to_address(first1), to_address(first2), n * sizeof(alloc::iterator_value_t<InputIterator1>));
+			}
+			//  ムーブのみ可能な型やデフォルトコンストラクタを持たない型もあるため範囲の長さは等しいものとする
+			else if constexpr (is_nothrow_move_constructible_v<value_t> || !is_copy_constructible_v<value_t>) {
+				while ((first1 != last1) && (first2 != last2)) construct(a, to_address(first1++), move(*to_address(first2++)));
+			}
+			else {
+				while ((first1 != last1) && (first2 != last2)) construct(a, to_address(first1++), *to_address(first2++));
+			}
+		}
+		//  pに確保されているn要素の領域をその場でsize要素へ拡張する(拡張できないときはfalse)
+		static bool expand(allocator_type& a, pointer p, size_t n, size_t size) {
+			if (p == nullptr) return false;
+			return alloc::Expand<allocator_type, pointer>::expand(a, p, n, size);
 		}
 		//  デストラクタの適用
 		template <class T>
@@ -199,7 +327,9 @@ namespace iml {
 			//  出力イテレータでなければならない
 			static_assert(is_iterator_v<OutputIterator, output_iterator_tag>, "The type of iterator is different.");
 
-			while (first != last) destroy(a, to_address(first++));
+			//  トリビアルに破棄可能ならば何もしない
+			if constexpr (!alloc::is_trivially_destroyable<allocator_type, OutputIterator>::value)
+				while (first != last) destroy(a, to_address(first++));
 		}
 		//  コンテナのコピー構築に使用するアロケータオブジェクトを取得
 		static constexpr allocator_type select_on_container_copy_construction(const allocator_type& a) {
@@ -213,9 +343,9 @@ namespace iml {
 	class allocator {
 	public:
 		constexpr allocator() noexcept {}
-		constexpr allocator(allocator&) noexcept {}
+		constexpr allocator(const allocator&) noexcept {}
 		template <class U>
-		constexpr allocator(allocator<U>&) noexcept {}
+		constexpr allocator(const allocator<U>&) noexcept {}
 		~allocator() {}
 
 		using value_type = T;
@@ -229,9 +359,9 @@ namespace iml {
 		using rebind_t = allocator<Other>;
 
 		//  メモリ確保(new[]で確保しないためdeleteで解放できる)
-		[[nodiscard]] pointer allocate(size_t n) { return static_cast<pointer>(::operator new(n * sizeof(value_type))); }
+		[[nodiscard]] pointer allocate(size_t n) { return static_cast<pointer>(alloc::aligned_new<alignof(value_type)>(n * sizeof(value_type))); }
 		//  メモリ解放
-		void deallocate(pointer p, size_t) { ::operator delete(static_cast<void*>(p)); }
+		void deallocate(pointer p, size_t) { alloc::aligned_delete<alignof(value_type)>(static_cast<void*>(p)); }
 	};
 	template <class T, class U>
 	bool operator==(const allocator<T>&, const allocator<U>&) { return true; }
@@ -239,6 +369,265 @@ namespace iml {
 	bool operator!=(const allocator<T>&, const allocator<U>&) { return false; }
 
 
+	//  Alignバイトに整列された領域を確保するアロケータ(SIMD命令のアラインされたロードとストアのため)
+	template <class T, size_t Align = alignof(T)>
+	class aligned_allocator {
+		static_assert((Align & (Align - 1)) == 0, "Align must be a power of two.");
+	public:
+		constexpr aligned_allocator() noexcept {}
+		constexpr aligned_allocator(const aligned_allocator&) noexcept {}
+		template <class U, size_t UAlign>
+		constexpr aligned_allocator(const aligned_allocator<U, UAlign>&) noexcept {}
+		~aligned_allocator() {}
+
+		using value_type = T;
+		using pointer = T * ;
+
+		//  Tの整列の要求がAlignより大きいときはそちらに従う
+		static constexpr size_t alignment = (Align < alignof(T)) ? alignof(T) : Align;
+
+		template <class Other>
+		struct rebind {
+			using other = aligned_allocator<Other, Align>;
+		};
+		template <class Other>
+		using rebind_t = aligned_allocator<Other, Align>;
+
+		//  メモリ確保
+		[[nodiscard]] pointer allocate(size_t n) { return static_cast<pointer>(alloc::aligned_new<alignment>(n * sizeof(value_type))); }
+		//  メモリ解放
+		void deallocate(pointer p, size_t) { alloc::aligned_delete<alignment>(static_cast<void*>(p)); }
+	};
+	template <class T, size_t TAlign, class U, size_t UAlign>
+	bool operator==(const aligned_allocator<T, TAlign>&, const aligned_allocator<U, UAlign>&) { return TAlign == UAlign; }
+	template <class T, size_t TAlign, class U, size_t UAlign>
+	bool operator!=(const aligned_allocator<T, TAlign>&, const aligned_allocator<U, UAlign>&) { return TAlign != UAlign; }
+
+
+	//  実行時に切り替え可能なメモリ資源(実装はmemory_resource.hpp)
+	class memory_resource {
+	public:
+		virtual ~memory_resource() {}
+
+		[[nodiscard]] void* allocate(size_t size, size_t align = alignof(max_align_t)) { return do_allocate(size, align); }
+		void deallocate(void* p, size_t size, size_t align = alignof(max_align_t)) { do_deallocate(p, size, align); }
+		bool is_equal(const memory_resource& r) const noexcept { return do_is_equal(r); }
+	private:
+		virtual void* do_allocate(size_t size, size_t align) = 0;
+		virtual void do_deallocate(void* p, size_t size, size_t align) = 0;
+		virtual bool do_is_equal(const memory_resource& r) const noexcept = 0;
+	};
+	inline bool operator==(const memory_resource& r1, const memory_resource& r2) noexcept { return (&r1 == &r2) || r1.is_equal(r2); }
+	inline bool operator!=(const memory_resource& r1, const memory_resource& r2) noexcept { return !(r1 == r2); }
+
+
+	//  単調増加なアリーナ(個別の解放は行わずにreset()で一括して巻き戻す)
+	class monotonic_arena {
+		//  チャンクのヘッダ(直後がチャンクの領域となる)
+		struct chunk {
+			chunk*	next_m;				//  次のチャンク
+			size_t	size_m;				//  ヘッダを除いたチャンクのサイズ
+			bool	owned_m;			//  アリーナが確保したチャンクであるか
+
+			unsigned char* begin() noexcept { return reinterpret_cast<unsigned char*>(this + 1); }
+			unsigned char* end() noexcept { return begin() + size_m; }
+		};
+
+		chunk*			head_m;				//  先頭のチャンク
+		chunk*			current_m;			//  使用中のチャンク
+		unsigned char*	pos_m;				//  使用中のチャンクの未使用領域の先頭
+		size_t			next_size_m;		//  次に確保するチャンクのサイズ
+		memory_resource*	upstream_m;		//  チャンクの確保先(nullptrのときは::operator new)
+
+		static inline thread_local monotonic_arena*	current_arena_m = nullptr;		//  スレッド毎の既定のアリーナ
+
+		//  sizeバイト以上を格納可能なチャンクをcurrent_mの直後に用意する
+		void next_chunk(size_t size) {
+			//  reset()により再利用可能なチャンクが存在するならばそれを用いる
+			for (chunk* prev = current_m, *ptr = (current_m != nullptr) ? current_m->next_m : head_m; ptr != nullptr; prev = ptr, ptr = ptr->next_m) {
+				if (ptr->size_m < size) continue;
+				//  容量の足りないチャンクを飛び越えたときはptrをcurrent_mの直後に付け替える
+				if (prev != current_m) {
+					prev->next_m = ptr->next_m;
+					ptr->next_m = current_m->next_m;
+					current_m->next_m = ptr;
+				}
+				current_m = ptr;
+				pos_m = ptr->begin();
+				return;
+			}
+			//  新たにチャンクを確保してcurrent_mの直後に挿入する
+			size_t chunk_size = (iml::max)(next_size_m, size);
+			chunk* temp = static_cast<chunk*>((upstream_m != nullptr) ? upstream_m->allocate(sizeof(chunk) + chunk_size, alignof(chunk)) : ::operator new(sizeof(chunk) + chunk_size));
+			temp->size_m = chunk_size;
+			temp->owned_m = true;
+			if (current_m == nullptr) { temp->next_m = head_m; head_m = temp; }
+			else { temp->next_m = current_m->next_m; current_m->next_m = temp; }
+			current_m = temp;
+			pos_m = temp->begin();
+			next_size_m = chunk_size * 2;
+		}
+	public:
+		//  reset()で巻き戻す位置
+		struct marker {
+			chunk*			chunk_m;
+			unsigned char*	pos_m;
+		};
+
+		explicit monotonic_arena(size_t initial_size = 4096, memory_resource* upstream = nullptr) : head_m(nullptr), current_m(nullptr), pos_m(nullptr), next_size_m(initial_size), upstream_m(upstream) {}
+		//  bufferを最初のチャンクとして用いる(bufferはアリーナより長く生存しなければならない)
+		monotonic_arena(void* buffer, size_t size, memory_resource* upstream = nullptr) : head_m(nullptr), current_m(nullptr), pos_m(nullptr), next_size_m(size), upstream_m(upstream) {
+			if (size <= sizeof(chunk) + alignof(chunk)) return;
+			//  チャンクのヘッダのためにbufferを整列する
+			unsigned char* p = static_cast<unsigned char*>(buffer);
+			size_t offset = (alignof(chunk) - reinterpret_cast<size_t>(p) % alignof(chunk)) % alignof(chunk);
+			head_m = current_m = reinterpret_cast<chunk*>(p + offset);
+			head_m->next_m = nullptr;
+			head_m->size_m = size - offset - sizeof(chunk);
+			head_m->owned_m = false;
+			pos_m = head_m->begin();
+		}
+		monotonic_arena(const monotonic_arena&) = delete;
+		~monotonic_arena() { release(); }
+
+		monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+		//  alignに整列されたsizeバイトの領域の確保
+		[[nodiscard]] void* allocate(size_t size, size_t align = alignof(max_align_t)) {
+			if (current_m != nullptr) {
+				size_t offset = (align - reinterpret_cast<size_t>(pos_m) % align) % align;
+				if (static_cast<size_t>(current_m->end() - pos_m) >= size + offset) {
+					void* result = pos_m + offset;
+					pos_m += size + offset;
+					return result;
+				}
+			}
+			//  整列のための余剰分を含めてチャンクを用意する
+			next_chunk(size + align);
+			size_t offset = (align - reinterpret_cast<size_t>(pos_m) % align) % align;
+			void* result = pos_m + offset;
+			pos_m += size + offset;
+			return result;
+		}
+
+		//  直前に確保したpのsizeバイトの領域をその場でnew_sizeバイトへ拡張する(拡張できないときはfalse)
+		bool expand(void* p, size_t size, size_t new_size) noexcept {
+			if ((current_m == nullptr) || (static_cast<unsigned char*>(p) + size != pos_m)) return false;
+			if (static_cast<size_t>(current_m->end() - static_cast<unsigned char*>(p)) < new_size) return false;
+			pos_m = static_cast<unsigned char*>(p) + new_size;
+			return true;
+		}
+
+		//  現在の位置の取得
+		marker mark() const noexcept { return marker{ current_m, pos_m }; }
+		//  markの位置まで巻き戻す(以降に確保された領域は全て無効となる)
+		void rewind(const marker& m) noexcept {
+			if (m.chunk_m == nullptr) { reset(); return; }
+			current_m = m.chunk_m;
+			pos_m = m.pos_m;
+		}
+		//  全ての領域を破棄して先頭に巻き戻す(チャンクは再利用のために保持する)
+		void reset() noexcept {
+			current_m = head_m;
+			pos_m = (head_m != nullptr) ? head_m->begin() : nullptr;
+		}
+		//  アリーナが確保したチャンクを全て解放する
+		void release() noexcept {
+			chunk* external = nullptr;
+			for (chunk* ptr = head_m; ptr != nullptr;) {
+				chunk* temp = ptr; ptr = ptr->next_m;
+				if (!temp->owned_m) external = temp;
+				else if (upstream_m != nullptr) upstream_m->deallocate(static_cast<void*>(temp), sizeof(chunk) + temp->size_m, alignof(chunk));
+				else ::operator delete(static_cast<void*>(temp));
+			}
+			//  外部から与えられたバッファは保持する
+			if (external != nullptr) external->next_m = nullptr;
+			head_m = external;
+			reset();
+		}
+
+		//  確保済みのチャンクの総容量
+		size_t capacity() const noexcept {
+			size_t result = 0;
+			for (chunk* ptr = head_m; ptr != nullptr; ptr = ptr->next_m) result += ptr->size_m;
+			return result;
+		}
+
+		//  このスレッドで既定として用いるアリーナ(arena_scopeによって設定される)
+		static monotonic_arena& current() {
+			if (current_arena_m != nullptr) return *current_arena_m;
+			static thread_local monotonic_arena default_arena;
+			return default_arena;
+		}
+		static monotonic_arena* exchange_current(monotonic_arena* arena) noexcept {
+			monotonic_arena* temp = current_arena_m;
+			current_arena_m = arena;
+			return temp;
+		}
+	};
+
+	//  スコープを抜けるときにアリーナを巻き戻す(スコープ内ではスレッドの既定のアリーナとなる)
+	class arena_scope {
+		monotonic_arena*			arena_m;
+		monotonic_arena::marker		marker_m;
+		monotonic_arena*			prev_m;				//  スコープに入る前の既定のアリーナ
+	public:
+		explicit arena_scope(monotonic_arena& arena) : arena_m(addressof(arena)), marker_m(arena.mark()), prev_m(monotonic_arena::exchange_current(addressof(arena))) {}
+		arena_scope(const arena_scope&) = delete;
+		~arena_scope() {
+			monotonic_arena::exchange_current(prev_m);
+			arena_m->rewind(marker_m);
+		}
+
+		arena_scope& operator=(const arena_scope&) = delete;
+	};
+
+	//  monotonic_arenaからメモリを確保するアロケータ(deallocateは何もしない)
+	template <class T>
+	class arena_allocator {
+		template <class>
+		friend class arena_allocator;
+
+		monotonic_arena*	arena_m;
+	public:
+		//  スレッドの既定のアリーナを用いる
+		arena_allocator() : arena_m(addressof(monotonic_arena::current())) {}
+		constexpr arena_allocator(monotonic_arena& arena) noexcept : arena_m(addressof(arena)) {}
+		constexpr arena_allocator(const arena_allocator& a) noexcept : arena_m(a.arena_m) {}
+		template <class U>
+		constexpr arena_allocator(const arena_allocator<U>& a) noexcept : arena_m(a.arena_m) {}
+		~arena_allocator() {}
+
+		using value_type = T;
+		using pointer = T * ;
+
+		template <class Other>
+		struct rebind {
+			using other = arena_allocator<Other>;
+		};
+		template <class Other>
+		using rebind_t = arena_allocator<Other>;
+
+		//  メモリ確保
+		[[nodiscard]] pointer allocate(size_t n) { return static_cast<pointer>(arena_m->allocate(n * sizeof(value_type), alignof(value_type))); }
+		//  メモリ解放(アリーナの巻き戻しによって一括で解放される)
+		void deallocate(pointer, size_t) noexcept {}
+		//  末尾の確保であればその場で拡張する
+		bool expand(pointer p, size_t n, size_t size) noexcept { return arena_m->expand(static_cast<void*>(p), n * sizeof(value_type), size * sizeof(value_type)); }
+
+		//  コピーされたコンテナも同一のアリーナを用いる
+		arena_allocator select_on_container_copy_construction() const { return *this; }
+
+		monotonic_arena& arena() const noexcept { return *arena_m; }
+
+		arena_allocator& operator=(const arena_allocator& a) noexcept { arena_m = a.arena_m; return *this; }
+	};
+	template <class T, class U>
+	bool operator==(const arena_allocator<T>& a1, const arena_allocator<U>& a2) { return addressof(a1.arena()) == addressof(a2.arena()); }
+	template <class T, class U>
+	bool operator!=(const arena_allocator<T>& a1, const arena_allocator<U>& a2) { return !(a1 == a2); }
+
+
 	//  リソースの破棄条件をdeallocator_baseを通して共通化する
 	namespace dealloc {
 		static constexpr size_t variable = 0;				//  newで確保されたインスタンスに対してdeleteをする
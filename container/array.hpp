@@ -3,6 +3,7 @@
 
 #include "IMathLib/utility/algorithm.hpp"
 #include "IMathLib/container/allocator.hpp"
+#include "IMathLib/container/memory_resource.hpp"
 #include "IMathLib/utility/smart_ptr.hpp"
 
 
@@ -57,6 +58,8 @@ namespace iml {
 		constexpr bool operator<=(const array_iterator& itr) const { return current_m <= itr.current_m; }
 		constexpr bool operator>=(const array_iterator& itr) const { return current_m >= itr.current_m; }
 	};
+	template <class T>
+	struct is_contiguous_iterator<array_iterator<T>> : true_type {};
 
 
 	//  静的配列リスト
@@ -127,13 +130,34 @@ namespace iml {
 		size_type	size_m;				//  確保したメモリサイズ
 		size_type	use_size_m;			//  確保したメモリのうち使用中のサイズ
 		Allocator	alloc_m;
+
+		//  size個の要素を格納するために確保する容量(容量を倍々に増やして末尾への追加を償却O(1)にする)
+		size_type recommend(size_type size) const {
+			if (max_size() < size) throw std::length_error("size exceeds max_size().");
+			return (iml::max)(size, (iml::min)(max_size(), size_m * 2));
+		}
+		//  容量をsizeにする(その場で拡張できなければ再確保してムーブ(例外を送出し得るならばコピー)で要素を移す)
+		void reallocate(size_type size) {
+			if ((size_m < size) && allocator_traits<Allocator>::expand(alloc_m, p_m, size_m, size)) {
+				size_m = size;
+				return;
+			}
+			auto temp = alloc_m.allocate(size);
+			allocator_traits<Allocator>::move_if_noexcept_construct(alloc_m, temp, temp + use_size_m, p_m, p_m + use_size_m);
+			allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
+			alloc_m.deallocate(p_m, size_m);
+			size_m = size;
+			p_m = temp;
+		}
 	public:
 		constexpr dynamic_array() : p_m(nullptr), size_m(0), use_size_m(0), alloc_m() {}
 		explicit dynamic_array(const Allocator& alloc) : p_m(nullptr), size_m(0), use_size_m(0)
 			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)) {}
-		dynamic_array(size_type size, const Allocator& alloc = Allocator()) : p_m(nullptr), size_m(0), use_size_m(size)
+		dynamic_array(size_type size, const Allocator& alloc = Allocator()) : p_m(nullptr), size_m(size), use_size_m(size)
 			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)) {
+			if (max_size() < size) throw std::length_error("size exceeds max_size().");
 			p_m = alloc_m.allocate(size_m);
+			allocator_traits<Allocator>::construct_all(alloc_m, p_m, p_m + use_size_m);
 		}
 		template <class InputIterator>
 		dynamic_array(InputIterator first, InputIterator last) : alloc_m() {
@@ -179,6 +203,8 @@ namespace iml {
 		size_type capacity() const { return size_m; }
 		//  コンテナに格納可能な最大サイズ
 		constexpr size_type max_size() const { return allocator_traits<Allocator>::max_size(alloc_m); }
+		//  アロケータの取得
+		allocator_type get_allocator() const { return alloc_m; }
 
 
 		//  要素数の再設定
@@ -191,25 +217,16 @@ namespace iml {
 				use_size_m = size;
 				return;
 			}
-			else if (size_m >= size) {
-				allocator_traits<Allocator>::construct_all(alloc_m, p_m + use_size_m, p_m + size);
-				use_size_m = size;
-				return;
-			}
-			if (max_size() < size) throw std::length_error("size exceeds max_size().");
 			//  メモリを再確保して構築
-			auto temp = alloc_m.allocate(size);
-			allocator_traits<Allocator>::move_construct(alloc_m, temp, temp + size, p_m, p_m + use_size_m);
-			allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
-			alloc_m.deallocate(p_m, size_m);
-			size_m = use_size_m = size;
-			p_m = temp;
+			if (size_m < size) reallocate(recommend(size));
+			allocator_traits<Allocator>::construct_all(alloc_m, p_m + use_size_m, p_m + size);
+			use_size_m = size;
 		}
 		void resize(size_type size, const T& c) {
 			//  確保されているメモリが十分に大きいときは余剰分にコピーコンストラクタかデストラクタを作用
 			if (use_size_m >= size) {
 				allocator_traits<Allocator>::destroy(alloc_m, p_m + size, p_m + use_size_m);
-				use_szie_m = size;
+				use_size_m = size;
 				return;
 			}
 			else if (size_m >= size) {
@@ -217,26 +234,17 @@ namespace iml {
 				use_size_m = size;
 				return;
 			}
-			if (max_size() < size) throw std::length_error("size exceeds max_size().");
-			//  メモリを再確保して構築
-			auto temp = alloc_m.allocate(size);
-			allocator_traits<Allocator>::move_construct(alloc_m, temp, temp + use_size_m, p_m, p_m + use_size_m);
-			allocator_traits<Allocator>::construct_all(alloc_m, temp + use_size_m, temp + size, c);
-			allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
-			alloc_m.deallocate(p_m, size_m);
-			size_m = use_size_m = size;
-			p_m = temp;
+			//  メモリを再確保して構築(cが自身の要素であるときのために予め複製する)
+			T temp(c);
+			reallocate(recommend(size));
+			allocator_traits<Allocator>::construct_all(alloc_m, p_m + use_size_m, p_m + size, temp);
+			use_size_m = size;
 		}
 		//  capacityよりもsizeが大きいときメモリの再確保
 		void reserve(size_type size) {
-			if (size < size_m) return;
+			if (size <= size_m) return;
 			if (max_size() < size) throw std::length_error("size exceeds max_size().");
-			auto temp = alloc_m.allocate(size);
-			allocator_traits<Allocator>::move_construct(alloc_m, temp, temp + use_size_m, p_m, p_m + use_size_m);
-			allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
-			alloc_m.deallocate(p_m, size_m);
-			size_m = size;
-			p_m = temp;
+			reallocate(size);
 		}
 
 
@@ -244,24 +252,29 @@ namespace iml {
 		//  itrに対してc
 		void insert(const_iterator itr, const T& c) {
 			if (!((begin() <= to_iterator(itr)) && (to_iterator(itr) <= end()))) return;		// イテレータの範囲外
+			auto itr_pos = distance(begin(), to_iterator(itr));
 			//  メモリを再確保する必要がある場合
-			if (size_m == use_size_m) {
-				if (max_size() == size_m) throw std::length_error("size exceeds max_size().");
-				size_type alloc_size = (iml::min)(max_size(), (size_m + 1) * 2);
-				auto temp = alloc_m.allocate(size_m);
-				auto itr_pos = distance(begin(), to_iterator(itr));
-				allocator_traits<Allocator>::move_construct(alloc_m, temp, temp + itr_pos, begin(), to_iterator(itr));
+			if ((size_m == use_size_m) && !allocator_traits<Allocator>::expand(alloc_m, p_m, size_m, recommend(use_size_m + 1))) {
+				size_type alloc_size = recommend(use_size_m + 1);
+				auto temp = alloc_m.allocate(alloc_size);
 				allocator_traits<Allocator>::construct(alloc_m, temp + itr_pos, c);
-				allocator_traits<Allocator>::move_construct(alloc_m, temp + itr_pos + 1, temp + use_size_m + 1, to_iterator(itr), end());
+				allocator_traits<Allocator>::move_if_noexcept_construct(alloc_m, temp, temp + itr_pos, p_m, p_m + itr_pos);
+				allocator_traits<Allocator>::move_if_noexcept_construct(alloc_m, temp + itr_pos + 1, temp + use_size_m + 1, p_m + itr_pos, p_m + use_size_m);
 				allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
 				alloc_m.deallocate(p_m, size_m);
 				size_m = alloc_size;
 				p_m = temp;
 			}
 			else {
-				allocator_traits<Allocator>::construct(alloc_m, p_m + use_size_m);
-				move_reverse_order(to_iterator(itr) + 1, to_iterator(itr), end());
-				*to_iterator(itr) = c;
+				if (size_m == use_size_m) size_m = recommend(use_size_m + 1);
+				if (itr_pos == use_size_m) allocator_traits<Allocator>::construct(alloc_m, p_m + use_size_m, c);
+				else {
+					//  cが自身の要素であるときのために予め複製する
+					T temp(c);
+					allocator_traits<Allocator>::construct(alloc_m, p_m + use_size_m, move(p_m[use_size_m - 1]));
+					move_reverse_order(p_m + itr_pos + 1, p_m + itr_pos, p_m + use_size_m - 1);
+					p_m[itr_pos] = move(temp);
+				}
 			}
 			++use_size_m;
 		}
@@ -271,28 +284,49 @@ namespace iml {
 			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
 			
 			if (!((begin() <= to_iterator(itr)) && (to_iterator(itr) <= end()))) return;		// イテレータの範囲外
-			size_type dist = distance(first, last);
-			size_type alloc_size = dist + use_size_m;			//  必要なメモリ領域
-			//  メモリを再確保する必要がある場合
-			if (size_m < alloc_size) {
-				if (max_size()  < alloc_size) throw std::length_error("size exceeds max_size().");
-				alloc_size = (iml::min)(max_size(), alloc_size * 2);
-				auto temp = alloc_m.allocate(alloc_size);
-				auto itr_pos = distance(begin(), to_iterator(itr));
-				allocator_traits<Allocator>::move_construct(alloc_m, temp, temp + itr_pos, begin(), to_iterator(itr));
-				allocator_traits<Allocator>::copy_construct(alloc_m, temp + itr_pos, temp + itr_pos + dist, first, last);
-				allocator_traits<Allocator>::move_construct(alloc_m, temp + itr_pos + dist, temp + use_size_m + dist, to_iterator(itr), end());
-				allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
-				alloc_m.deallocate(p_m, size_m);
-				size_m = alloc_size;
-				p_m = temp;
+			//  前方向イテレータでなければ要素数が分からないため一旦別の領域に格納する
+			if constexpr (!is_iterator_v<InputIterator, forward_iterator_tag>) {
+				dynamic_array temp(alloc_m);
+				for (; first != last; ++first) temp.emplace_back(*first);
+				insert(itr, temp.begin(), temp.end());
+				return;
 			}
 			else {
-				allocator_traits<Allocator>::construct_all(alloc_m, p_m + use_size_m, p_m + use_size_m + dist);
-				move_reverse_order(to_iterator(itr) + dist, to_iterator(itr), end());
-				copy_order(to_iterator(itr), first, last);
+				size_type pos = distance(begin(), to_iterator(itr));
+				size_type dist = distance(first, last);
+				if (dist == 0) return;
+				//  メモリを再確保する必要がある場合
+				if ((size_m < use_size_m + dist) && !allocator_traits<Allocator>::expand(alloc_m, p_m, size_m, recommend(use_size_m + dist))) {
+					size_type alloc_size = recommend(use_size_m + dist);
+					auto temp = alloc_m.allocate(alloc_size);
+					allocator_traits<Allocator>::copy_construct(alloc_m, temp + pos, temp + pos + dist, first, last);
+					allocator_traits<Allocator>::move_if_noexcept_construct(alloc_m, temp, temp + pos, p_m, p_m + pos);
+					allocator_traits<Allocator>::move_if_noexcept_construct(alloc_m, temp + pos + dist, temp + use_size_m + dist, p_m + pos, p_m + use_size_m);
+					allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
+					alloc_m.deallocate(p_m, size_m);
+					size_m = alloc_size;
+					p_m = temp;
+				}
+				else {
+					if (size_m < use_size_m + dist) size_m = recommend(use_size_m + dist);
+					size_type tail = use_size_m - pos;				//  挿入位置より後ろの要素数
+					//  後ろの要素は一度だけずらす
+					if (tail > dist) {
+						//  末尾のdist個を未構築の領域へムーブして残りを後ろへずらす
+						allocator_traits<Allocator>::move_construct(alloc_m, p_m + use_size_m, p_m + use_size_m + dist, p_m + use_size_m - dist, p_m + use_size_m);
+						move_reverse_order(p_m + pos + dist, p_m + pos, p_m + use_size_m - dist);
+						copy_order(p_m + pos, first, last);
+					}
+					else {
+						//  挿入する要素のうち未構築の領域に入る分を構築してから後ろの要素をムーブする
+						InputIterator mid = next(first, tail);
+						allocator_traits<Allocator>::copy_construct(alloc_m, p_m + use_size_m, p_m + pos + dist, mid, last);
+						allocator_traits<Allocator>::move_construct(alloc_m, p_m + pos + dist, p_m + use_size_m + dist, p_m + pos, p_m + use_size_m);
+						copy_order(p_m + pos, first, mid);
+					}
+				}
+				use_size_m += dist;
 			}
-			use_size_m += dist;
 		}
 		//  要素の削除(emptyなときはiteratorが無効であるため削除不可)
 		//  itrの位置
@@ -304,6 +338,8 @@ namespace iml {
 		}
 		//  [first,last)の範囲
 		void erase(const_iterator first, const_iterator last) {
+			if (first == last) return;
+			//  後ろの要素を一度だけ前に詰めて末尾を除去する
 			move_order(to_iterator(first), to_iterator(last), end());
 			size_type dist = distance(first, last);
 			allocator_traits<Allocator>::destroy(alloc_m, p_m + use_size_m - dist, p_m + use_size_m);
@@ -312,15 +348,28 @@ namespace iml {
 
 
 		// 後方にデータの挿入
-		dynamic_array& push_back(const T& v) {
+		dynamic_array& push_back(const T& v) { emplace_back(v); return *this; }
+		dynamic_array& push_back(T&& v) { emplace_back(move(v)); return *this; }
+		//  後方に引数から直接構築
+		template <class... Types>
+		reference emplace_back(Types&&... args) {
 			//  領域が足りないときはメモリ再確保
-			if (size_m == use_size_m) {
-				if (max_size() == size_m) throw std::length_error("size exceeds max_size().");
-				reserve((iml::min)(max_size(), (size_m + 1) * 2));
+			if ((size_m == use_size_m) && !allocator_traits<Allocator>::expand(alloc_m, p_m, size_m, recommend(use_size_m + 1))) {
+				//  引数が自身の要素であるときのために新しい領域へ先に構築してから要素を移す
+				size_type alloc_size = recommend(use_size_m + 1);
+				auto temp = alloc_m.allocate(alloc_size);
+				allocator_traits<Allocator>::construct(alloc_m, temp + use_size_m, forward<Types>(args)...);
+				allocator_traits<Allocator>::move_if_noexcept_construct(alloc_m, temp, temp + use_size_m, p_m, p_m + use_size_m);
+				allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
+				alloc_m.deallocate(p_m, size_m);
+				size_m = alloc_size;
+				p_m = temp;
 			}
-			allocator_traits<Allocator>::construct(alloc_m, p_m + use_size_m, v);
-			++use_size_m;
-			return *this;
+			else {
+				if (size_m == use_size_m) size_m = recommend(use_size_m + 1);
+				allocator_traits<Allocator>::construct(alloc_m, p_m + use_size_m, forward<Types>(args)...);
+			}
+			return p_m[use_size_m++];
 		}
 		//  後方のデータの削除
 		dynamic_array& pop_back() {
@@ -334,12 +383,8 @@ namespace iml {
 		//  メモリを使用サイズにフィットさせる
 		void shrink_to_fit() {
 			if (size_m == use_size_m) return;
-			auto temp = alloc_m.allocate(use_size_m);
-			allocator_traits<Allocator>::move_construct(alloc_m, temp, temp + use_size_m, p_m, p_m + use_size_m);
-			allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
-			alloc_m.deallocate(p_m, size_m);
-			size_m = use_size_m;
-			p_m = temp;
+			if (use_size_m == 0) { clear(); return; }
+			reallocate(use_size_m);
 		}
 
 
@@ -371,6 +416,7 @@ namespace iml {
 		}
 		dynamic_array& operator=(dynamic_array&& a) {
 			if (a.p_m == p_m) return *this;
+			clear();
 			alloc_m = a.alloc_m;
 			size_m = a.size_m;
 			use_size_m = a.use_size_m;
@@ -401,11 +447,304 @@ namespace iml {
 	}
 
 
+	//  N個までの要素を内部に保持し，それを超えるとアロケータにより確保する配列リスト
+	template <class T, size_t N, class Allocator = allocator<T>>
+	class small_array {
+		static_assert(N > 0, "N must be greater than zero.");
+	public:
+		using value_type = T;
+		using reference = T & ;
+		using const_reference = const T &;
+		using iterator = array_iterator<T>;
+		using const_iterator = array_iterator<const T>;
+		using allocator_type = Allocator;
+		using size_type = typename allocator_traits<Allocator>::size_type;
+	private:
+		T*			p_m;				//  inline_mかアロケータにより確保した領域を指す
+		size_type	size_m;				//  確保したメモリサイズ
+		size_type	use_size_m;			//  確保したメモリのうち使用中のサイズ
+		Allocator	alloc_m;
+		alignas(T) unsigned char	inline_m[sizeof(T) * N];		//  内部に保持する領域
+
+		T* inline_data() noexcept { return reinterpret_cast<T*>(inline_m); }
+		bool is_inline_data(const T* p) const noexcept { return p == reinterpret_cast<const T*>(inline_m); }
+
+		//  sizeだけの領域を用意して要素を移動する(N以下ならば内部の領域を用いる)
+		void reallocate(size_type size) {
+			if (max_size() < size) throw std::length_error("size exceeds max_size().");
+			T* temp = (size <= N) ? inline_data() : alloc_m.allocate(size);
+			if (temp == p_m) return;
+			allocator_traits<Allocator>::move_if_noexcept_construct(alloc_m, temp, temp + use_size_m, p_m, p_m + use_size_m);
+			allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
+			if (!is_inline()) alloc_m.deallocate(p_m, size_m);
+			p_m = temp;
+			size_m = (size <= N) ? N : size;
+		}
+		//  aの要素をムーブしてaを空にする
+		void steal(small_array& a) {
+			if (a.is_inline()) {
+				p_m = inline_data();
+				size_m = N;
+				use_size_m = a.use_size_m;
+				allocator_traits<Allocator>::move_construct(alloc_m, p_m, p_m + use_size_m, a.p_m, a.p_m + a.use_size_m);
+				allocator_traits<Allocator>::destroy(alloc_m, a.p_m, a.p_m + a.use_size_m);
+			}
+			else {
+				p_m = a.p_m;
+				size_m = a.size_m;
+				use_size_m = a.use_size_m;
+			}
+			a.p_m = a.inline_data();
+			a.size_m = N;
+			a.use_size_m = 0;
+		}
+	public:
+		small_array() : p_m(inline_data()), size_m(N), use_size_m(0), alloc_m() {}
+		explicit small_array(const Allocator& alloc) : p_m(inline_data()), size_m(N), use_size_m(0)
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)) {}
+		small_array(size_type size, const Allocator& alloc = Allocator()) : p_m(inline_data()), size_m(N), use_size_m(0)
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)) {
+			resize(size);
+		}
+		template <class InputIterator>
+		small_array(InputIterator first, InputIterator last) : p_m(inline_data()), size_m(N), use_size_m(0), alloc_m() {
+			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
+
+			size_type dist = distance(first, last);
+			if (dist > N) reallocate(dist);
+			allocator_traits<Allocator>::copy_construct(alloc_m, p_m, p_m + dist, first, last);
+			use_size_m = dist;
+		}
+		small_array(const small_array& a) : p_m(inline_data()), size_m(N), use_size_m(0)
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(a.alloc_m)) {
+			if (a.use_size_m > N) reallocate(a.use_size_m);
+			allocator_traits<Allocator>::copy_construct(alloc_m, p_m, p_m + a.use_size_m, a.p_m, a.p_m + a.use_size_m);
+			use_size_m = a.use_size_m;
+		}
+		small_array(small_array&& a) : p_m(inline_data()), size_m(N), use_size_m(0), alloc_m(a.alloc_m) { steal(a); }
+		~small_array() {
+			allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
+			if (!is_inline()) alloc_m.deallocate(p_m, size_m);
+		}
+
+		iterator begin() noexcept { return iterator(p_m); }
+		const_iterator begin() const noexcept { return const_iterator(p_m); }
+		iterator end() noexcept { return iterator(p_m + use_size_m); }
+		const_iterator end() const noexcept { return const_iterator(p_m + use_size_m); }
+
+		//  空かの判定
+		[[nodiscard]] bool empty() const noexcept { return use_size_m == 0; }
+		//  内部の領域を用いているかの判定
+		bool is_inline() const noexcept { return is_inline_data(p_m); }
+		//  データの破棄(内部の領域へ戻る)
+		void clear() {
+			allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + use_size_m);
+			if (!is_inline()) alloc_m.deallocate(p_m, size_m);
+			p_m = inline_data();
+			size_m = N;
+			use_size_m = 0;
+		}
+		//  同一要素で埋める
+		void fill(const T& n) { iml::fill(p_m, p_m + use_size_m, n); }
+		//  使用中のサイズの取得
+		size_type size() const { return use_size_m; }
+		//  容量
+		size_type capacity() const { return size_m; }
+		//  コンテナに格納可能な最大サイズ
+		constexpr size_type max_size() const { return allocator_traits<Allocator>::max_size(alloc_m); }
+
+
+		//  要素数の再設定
+		void resize(size_type size) {
+			if (use_size_m >= size) {
+				allocator_traits<Allocator>::destroy(alloc_m, p_m + size, p_m + use_size_m);
+				use_size_m = size;
+				return;
+			}
+			if (size_m < size) reallocate(size);
+			allocator_traits<Allocator>::construct_all(alloc_m, p_m + use_size_m, p_m + size);
+			use_size_m = size;
+		}
+		void resize(size_type size, const T& c) {
+			if (use_size_m >= size) {
+				allocator_traits<Allocator>::destroy(alloc_m, p_m + size, p_m + use_size_m);
+				use_size_m = size;
+				return;
+			}
+			if (size_m < size) {
+				//  cが自身の要素であるときのために予め複製する
+				T temp(c);
+				reallocate(size);
+				allocator_traits<Allocator>::construct_all(alloc_m, p_m + use_size_m, p_m + size, temp);
+			}
+			else allocator_traits<Allocator>::construct_all(alloc_m, p_m + use_size_m, p_m + size, c);
+			use_size_m = size;
+		}
+		//  capacityよりもsizeが大きいときメモリの再確保
+		void reserve(size_type size) {
+			if (size <= size_m) return;
+			reallocate(size);
+		}
+
+
+		//  要素の挿入
+		//  itrに対してc
+		void insert(const_iterator itr, const T& c) {
+			if (!((begin() <= to_iterator(itr)) && (to_iterator(itr) <= end()))) return;		// イテレータの範囲外
+			size_type pos = distance(begin(), to_iterator(itr));
+			T temp(c);
+			if (size_m == use_size_m) reallocate((iml::min)(max_size(), (size_m + 1) * 2));
+			if (pos == use_size_m) allocator_traits<Allocator>::construct(alloc_m, p_m + use_size_m, move(temp));
+			else {
+				//  末尾を1つ後ろへムーブしてから空いた位置に代入
+				allocator_traits<Allocator>::construct(alloc_m, p_m + use_size_m, move(p_m[use_size_m - 1]));
+				move_reverse_order(p_m + pos + 1, p_m + pos, p_m + use_size_m - 1);
+				p_m[pos] = move(temp);
+			}
+			++use_size_m;
+		}
+		//  itrに対して[first,last)
+		template <class InputIterator>
+		void insert(const_iterator itr, InputIterator first, InputIterator last) {
+			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
+
+			if (!((begin() <= to_iterator(itr)) && (to_iterator(itr) <= end()))) return;		// イテレータの範囲外
+			//  前方向イテレータでなければ要素数が分からないため一旦別の領域に格納する
+			if constexpr (!is_iterator_v<InputIterator, forward_iterator_tag>) {
+				dynamic_array<T, Allocator> temp(alloc_m);
+				for (; first != last; ++first) temp.emplace_back(*first);
+				insert(itr, temp.begin(), temp.end());
+				return;
+			}
+			else {
+				size_type pos = distance(begin(), to_iterator(itr));
+				size_type dist = distance(first, last);
+				if (dist == 0) return;
+				if (size_m < use_size_m + dist) reallocate((iml::max)(use_size_m + dist, (iml::min)(max_size(), size_m * 2)));
+				size_type tail = use_size_m - pos;				//  挿入位置より後ろの要素数
+				if (tail > dist) {
+					//  末尾のdist個を未構築の領域へムーブして残りを後ろへずらす
+					allocator_traits<Allocator>::move_construct(alloc_m, p_m + use_size_m, p_m + use_size_m + dist, p_m + use_size_m - dist, p_m + use_size_m);
+					move_reverse_order(p_m + pos + dist, p_m + pos, p_m + use_size_m - dist);
+					copy_order(p_m + pos, first, last);
+				}
+				else {
+					//  挿入する要素のうち未構築の領域に入る分を構築してから後ろの要素をムーブする
+					InputIterator mid = next(first, tail);
+					allocator_traits<Allocator>::copy_construct(alloc_m, p_m + use_size_m, p_m + pos + dist, mid, last);
+					allocator_traits<Allocator>::move_construct(alloc_m, p_m + pos + dist, p_m + use_size_m + dist, p_m + pos, p_m + use_size_m);
+					copy_order(p_m + pos, first, mid);
+				}
+				use_size_m += dist;
+			}
+		}
+		//  要素の削除
+		//  itrの位置
+		void erase(const_iterator itr) {
+			//  itrの分だけ前に詰めて後ろを除去する
+			move_order(to_iterator(itr), to_iterator(itr + 1), end());
+			allocator_traits<Allocator>::destroy(alloc_m, p_m + use_size_m - 1);
+			--use_size_m;
+		}
+		//  [first,last)の範囲
+		void erase(const_iterator first, const_iterator last) {
+			if (first == last) return;
+			move_order(to_iterator(first), to_iterator(last), end());
+			size_type dist = distance(first, last);
+			allocator_traits<Allocator>::destroy(alloc_m, p_m + use_size_m - dist, p_m + use_size_m);
+			use_size_m -= dist;
+		}
+
+
+		// 後方にデータの挿入
+		small_array& push_back(const T& v) {
+			if (size_m == use_size_m) {
+				T temp(v);
+				reallocate((iml::min)(max_size(), size_m * 2));
+				allocator_traits<Allocator>::construct(alloc_m, p_m + use_size_m, move(temp));
+			}
+			else allocator_traits<Allocator>::construct(alloc_m, p_m + use_size_m, v);
+			++use_size_m;
+			return *this;
+		}
+		//  後方のデータの削除
+		small_array& pop_back() {
+			if (use_size_m == 0) return *this;
+			allocator_traits<Allocator>::destroy(alloc_m, p_m + use_size_m - 1);
+			--use_size_m;
+			return *this;
+		}
+
+
+		//  メモリを使用サイズにフィットさせる(N以下ならば内部の領域へ戻る)
+		void shrink_to_fit() {
+			if (is_inline() || (size_m == use_size_m)) return;
+			reallocate(use_size_m);
+		}
+
+
+		//  コンテナの中身の入れ替え
+		void swap(small_array& a) {
+			small_array temp(move(a));
+			a = move(*this);
+			*this = move(temp);
+		}
+
+		//  代入
+		small_array& operator=(const small_array& a) {
+			if (this == &a) return *this;
+			clear();
+			alloc_m = allocator_traits<Allocator>::select_on_container_copy_construction(a.alloc_m);
+			if (a.use_size_m > N) reallocate(a.use_size_m);
+			allocator_traits<Allocator>::copy_construct(alloc_m, p_m, p_m + a.use_size_m, a.p_m, a.p_m + a.use_size_m);
+			use_size_m = a.use_size_m;
+			return *this;
+		}
+		small_array& operator=(small_array&& a) {
+			if (this == &a) return *this;
+			clear();
+			alloc_m = a.alloc_m;
+			steal(a);
+			return *this;
+		}
+
+		reference operator[](size_type index) noexcept { return p_m[index]; }
+		const_reference operator[](size_type index) const noexcept { return p_m[index]; }
+
+		//  内部イテレータ
+		template <class F>
+		F for_each(F f) const { return iml::for_each(p_m, p_m + use_size_m, f); }
+	};
+	template <class T, class U, size_t N, size_t M, class TAllocator, class UAllocator>
+	constexpr bool operator==(const small_array<T, N, TAllocator>& a1, const small_array<U, M, UAllocator>& a2) {
+		if (a1.size() != a2.size()) return false;
+		auto itr1 = a1.begin();
+		auto itr2 = a2.begin();
+		for (; itr1 != a1.end(); ++itr1, ++itr2) if (*itr1 != *itr2) return false;
+		return true;
+	}
+	template <class T, class U, size_t N, size_t M, class TAllocator, class UAllocator>
+	constexpr bool operator!=(const small_array<T, N, TAllocator>& a1, const small_array<U, M, UAllocator>& a2) {
+		return !(a1 == a2);
+	}
+
+
+	//  memory_resourceにより実行時にメモリ確保の方法を切り替えるコンテナ
+	namespace pmr {
+		template <class T>
+		using dynamic_array = iml::dynamic_array<T, polymorphic_allocator<T>>;
+		template <class T, size_t N>
+		using small_array = iml::small_array<T, N, polymorphic_allocator<T>>;
+	}
+
+
 	//  配列の判定の登録
 	template<class T, size_t N>
 	struct is_array<static_array<T, N>> : true_type {};
 	template<class T, class Allocator>
 	struct is_array<dynamic_array<T, Allocator>> : true_type {};
+	template<class T, size_t N, class Allocator>
+	struct is_array<small_array<T, N, Allocator>> : true_type {};
 
 }
 
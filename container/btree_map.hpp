@@ -0,0 +1,548 @@
+﻿#ifndef IMATHLIB_CONTAINER_BTREE_MAP_HPP
+#define IMATHLIB_CONTAINER_BTREE_MAP_HPP
+
+#include "IMathLib/container/allocator.hpp"
+#include "IMathLib/container/memory_resource.hpp"
+#include "IMathLib/utility/tuple.hpp"
+
+
+//  B+木による連想配列
+namespace iml {
+
+	//  1ノードあたりの既定のキーの数
+	template <class T>
+	inline constexpr size_t btree_map_default_node_size = (sizeof(T) <= 16) ? 16 : 8;
+
+
+	//  B+木のノードの共通部分
+	struct btree_map_node_base {
+		size_t		size_m;				//  葉ならば要素数,内部ノードならばキーの数
+	};
+
+	//  B+木の葉(要素を格納して前後の葉と連結する)
+	template <class T, size_t N>
+	struct btree_map_leaf : btree_map_node_base {
+		btree_map_leaf*		prev_m;			//  前の葉
+		btree_map_leaf*		next_m;			//  次の葉
+		alignas(T) unsigned char	data_m[sizeof(T) * N];
+
+		constexpr btree_map_leaf(btree_map_leaf* prev, btree_map_leaf* next) : btree_map_node_base{ 0 }, prev_m(prev), next_m(next) {}
+
+		T* data() noexcept { return reinterpret_cast<T*>(data_m); }
+		const T* data() const noexcept { return reinterpret_cast<const T*>(data_m); }
+	};
+
+	//  B+木の内部ノード(child_m[i]の部分木のキーkはkey()[i - 1] <= k < key()[i]を満たす)
+	//  分割の前に一時的に溢れた状態とするため1つ余分に領域を持つ
+	template <class Key, size_t N>
+	struct btree_map_internal : btree_map_node_base {
+		btree_map_node_base*		child_m[N + 2];
+		alignas(Key) unsigned char	key_m[sizeof(Key) * (N + 1)];
+
+		constexpr btree_map_internal() : btree_map_node_base{ 0 }, child_m{} {}
+
+		Key* key() noexcept { return reinterpret_cast<Key*>(key_m); }
+		const Key* key() const noexcept { return reinterpret_cast<const Key*>(key_m); }
+	};
+
+
+	//  B+木のイテレータ(葉の連結を辿るため後続の要素はO(1)で得られる)
+	template <class T, size_t N>
+	struct btree_map_iterator {
+		using leaf_type = btree_map_leaf<remove_const_t<T>, N>;
+
+		leaf_type*	leaf_m;				//  要素を格納している葉
+		size_t		index_m;			//  葉の中での位置(終端のときは最後の葉の要素数)
+
+		using iterator_category = bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		template <class Other>
+		struct rebind {
+			using other = btree_map_iterator<Other, N>;
+		};
+		template <class Other>
+		using rebind_t = btree_map_iterator<Other, N>;
+
+		constexpr btree_map_iterator() : leaf_m(nullptr), index_m(0) {}
+		constexpr btree_map_iterator(leaf_type* leaf, size_t index) : leaf_m(leaf), index_m(index) {}
+		template <class U>
+		constexpr btree_map_iterator(const btree_map_iterator<U, N>& itr) : leaf_m(itr.leaf_m), index_m(itr.index_m) {}
+
+		reference operator*() const { return leaf_m->data()[index_m]; }
+		pointer operator->() const { return leaf_m->data() + index_m; }
+		btree_map_iterator& operator++() {
+			//  葉の終端に達したときは次の葉の先頭へ進む(最後の葉ならば終端となる)
+			if ((++index_m == leaf_m->size_m) && (leaf_m->next_m != nullptr)) {
+				leaf_m = leaf_m->next_m;
+				index_m = 0;
+			}
+			return *this;
+		}
+		btree_map_iterator operator++(int) { btree_map_iterator temp = *this; ++*this; return temp; }
+		btree_map_iterator& operator--() {
+			if (index_m == 0) {
+				leaf_m = leaf_m->prev_m;
+				index_m = leaf_m->size_m;
+			}
+			--index_m;
+			return *this;
+		}
+		btree_map_iterator operator--(int) { btree_map_iterator temp = *this; --*this; return temp; }
+
+		bool operator==(const btree_map_iterator& itr) const { return (leaf_m == itr.leaf_m) && (index_m == itr.index_m); }
+		bool operator!=(const btree_map_iterator& itr) const { return !(*this == itr); }
+	};
+
+
+	//  B+木による連想配列(要素は葉にのみ格納され,葉は双方向に連結される)
+	//  1ノードにN個までのキーを持つため赤黒木よりも木が低く,範囲の走査は葉の連続した領域を辿るのみとなる
+	//  tree_mapと同様にキーの比較はoperator<による
+	//  要素の挿入と削除によって全てのイテレータは無効となる
+	template <class Key, class T, class Compare = type_comparison<Key>, size_t N = btree_map_default_node_size<pair<Key, T>>, class Allocator = allocator<pair<Key, T>>>
+	class btree_map {
+		static_assert(N >= 4, "the node must be able to hold at least 4 keys.");
+	public:
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = pair<Key, T>;
+		using reference = value_type & ;
+		using const_reference = const value_type &;
+		using iterator = btree_map_iterator<value_type, N>;
+		using const_iterator = btree_map_iterator<const value_type, N>;
+		using allocator_type = Allocator;
+		using size_type = typename allocator_traits<Allocator>::size_type;
+
+		static constexpr size_t node_size = N;
+	private:
+		using node_base = btree_map_node_base;
+		using leaf_type = btree_map_leaf<value_type, N>;
+		using internal_type = btree_map_internal<Key, N>;
+		using leaf_allocator = typename allocator_traits<Allocator>::template rebind_t<leaf_type>;
+		using internal_allocator = typename allocator_traits<Allocator>::template rebind_t<internal_type>;
+
+		static constexpr size_t min_size = N / 2;			//  根以外のノードが保持する最小の要素数
+		static constexpr size_t max_height = 64;
+
+		node_base*		root_m;				//  根
+		leaf_type*		first_m;			//  一番最初の葉
+		leaf_type*		last_m;				//  一番最後の葉
+		size_t			height_m;			//  木の高さ(空のときは0,根が葉のときは1)
+		size_type		size_m;				//  要素数
+		Allocator		alloc_m;
+
+		//  根から葉までの経路
+		struct path_type {
+			internal_type*	node_m[max_height];
+			size_t			index_m[max_height];			//  辿った子の位置
+		};
+
+		//  prevとnextの間に葉を作成する
+		leaf_type* create_leaf(leaf_type* prev, leaf_type* next) {
+			leaf_allocator a(alloc_m);
+			leaf_type* temp = a.allocate(1);
+			::new (static_cast<void*>(temp)) leaf_type(prev, next);
+			if (prev == nullptr) first_m = temp;
+			else prev->next_m = temp;
+			if (next == nullptr) last_m = temp;
+			else next->prev_m = temp;
+			return temp;
+		}
+		//  要素が空となった葉を連結から外して解放する
+		void remove_leaf(leaf_type* leaf) {
+			if (leaf->prev_m == nullptr) first_m = leaf->next_m;
+			else leaf->prev_m->next_m = leaf->next_m;
+			if (leaf->next_m == nullptr) last_m = leaf->prev_m;
+			else leaf->next_m->prev_m = leaf->prev_m;
+			leaf_allocator a(alloc_m);
+			a.deallocate(leaf, 1);
+		}
+		internal_type* create_internal() {
+			internal_allocator a(alloc_m);
+			internal_type* temp = a.allocate(1);
+			::new (static_cast<void*>(temp)) internal_type();
+			return temp;
+		}
+		//  キーが空となった内部ノードを解放する
+		void remove_internal(internal_type* node) {
+			internal_allocator a(alloc_m);
+			a.deallocate(node, 1);
+		}
+		//  部分木の全ての要素とノードを解放する
+		void destroy_tree(node_base* node, size_t height) {
+			if (height == 1) {
+				leaf_type* leaf = static_cast<leaf_type*>(node);
+				allocator_traits<Allocator>::destroy(alloc_m, leaf->data(), leaf->data() + leaf->size_m);
+				leaf_allocator a(alloc_m);
+				a.deallocate(leaf, 1);
+				return;
+			}
+			internal_type* in = static_cast<internal_type*>(node);
+			for (size_t i = 0; i <= in->size_m; ++i) destroy_tree(in->child_m[i], height - 1);
+			for (size_t i = 0; i < in->size_m; ++i) in->key()[i].~Key();
+			remove_internal(in);
+		}
+
+		//  葉の中でkey以上となる最初の位置
+		static size_t leaf_lower_bound(const leaf_type* leaf, const key_type& key) {
+			size_t i = 0;
+			for (const value_type* p = leaf->data(); (i < leaf->size_m) && (p[i].first < key); ++i);
+			return i;
+		}
+		//  keyを含む部分木の位置
+		static size_t child_index(const internal_type* in, const key_type& key) {
+			size_t i = 0;
+			for (const Key* p = in->key(); (i < in->size_m) && !(key < p[i]); ++i);
+			return i;
+		}
+		//  keyを含む葉(pathが与えられたときは経路を記録する)
+		leaf_type* find_leaf(const key_type& key, path_type* path = nullptr) const {
+			node_base* node = root_m;
+			for (size_t h = 0; h + 1 < height_m; ++h) {
+				internal_type* in = static_cast<internal_type*>(node);
+				size_t i = child_index(in, key);
+				if (path != nullptr) {
+					path->node_m[h] = in;
+					path->index_m[h] = i;
+				}
+				node = in->child_m[i];
+			}
+			return static_cast<leaf_type*>(node);
+		}
+		//  葉の位置iを終端として正規化する(次の葉があればその先頭とする)
+		static iterator leaf_position(leaf_type* leaf, size_t i) {
+			if ((i == leaf->size_m) && (leaf->next_m != nullptr)) return iterator(leaf->next_m, 0);
+			return iterator(leaf, i);
+		}
+
+		//  満杯でない葉のiの位置に要素を挿入する
+		void leaf_insert(leaf_type* leaf, size_t i, value_type&& v) {
+			value_type* p = leaf->data();
+			if (i == leaf->size_m) allocator_traits<Allocator>::construct(alloc_m, p + i, move(v));
+			else {
+				allocator_traits<Allocator>::construct(alloc_m, p + leaf->size_m, move(p[leaf->size_m - 1]));
+				move_reverse_order(p + i + 1, p + i, p + leaf->size_m - 1);
+				p[i] = move(v);
+			}
+			++leaf->size_m;
+		}
+		//  葉のiの位置の要素を削除する
+		void leaf_erase(leaf_type* leaf, size_t i) {
+			value_type* p = leaf->data();
+			move_order(p + i, p + i + 1, p + leaf->size_m);
+			allocator_traits<Allocator>::destroy(alloc_m, p + --leaf->size_m);
+		}
+		//  内部ノードのi番目のキーとi + 1番目の子としてkeyとchildを挿入する
+		static void internal_insert(internal_type* in, size_t i, Key&& key, node_base* child) {
+			Key* p = in->key();
+			if (i == in->size_m) ::new (static_cast<void*>(p + i)) Key(move(key));
+			else {
+				::new (static_cast<void*>(p + in->size_m)) Key(move(p[in->size_m - 1]));
+				move_reverse_order(p + i + 1, p + i, p + in->size_m - 1);
+				p[i] = move(key);
+			}
+			for (size_t j = in->size_m + 1; j > i + 1; --j) in->child_m[j] = in->child_m[j - 1];
+			in->child_m[i + 1] = child;
+			++in->size_m;
+		}
+		//  内部ノードのi番目のキーとi + 1番目の子を削除する
+		static void internal_erase(internal_type* in, size_t i) {
+			Key* p = in->key();
+			move_order(p + i, p + i + 1, p + in->size_m);
+			p[--in->size_m].~Key();
+			for (size_t j = i + 1; j <= in->size_m; ++j) in->child_m[j] = in->child_m[j + 1];
+		}
+
+		//  新しい要素を挿入してその位置を返す
+		iterator insert_new(leaf_type* leaf, size_t i, path_type& path, value_type&& v) {
+			++size_m;
+			if (leaf->size_m < N) {
+				leaf_insert(leaf, i, move(v));
+				return iterator(leaf, i);
+			}
+			//  葉を分割する(最後の葉の末尾への追加ならば新しい葉には追加する要素のみを置いて葉を満杯のまま残す)
+			size_t half = ((i == N) && (leaf->next_m == nullptr)) ? N : N / 2;
+			leaf_type* right = create_leaf(leaf, leaf->next_m);
+			allocator_traits<Allocator>::move_construct(alloc_m, right->data(), right->data() + (N - half), leaf->data() + half, leaf->data() + N);
+			allocator_traits<Allocator>::destroy(alloc_m, leaf->data() + half, leaf->data() + N);
+			right->size_m = N - half;
+			leaf->size_m = half;
+			iterator result = ((i <= half) && (half != N)) ? iterator(leaf, i) : iterator(right, i - half);
+			leaf_insert(result.leaf_m, result.index_m, move(v));
+
+			//  分割の境界のキーを親へ挿入する(親が溢れたときは更に分割する)
+			Key sep = right->data()[0].first;
+			node_base* child = right;
+			for (size_t h = height_m - 1; h-- > 0;) {
+				internal_type* in = path.node_m[h];
+				size_t pos = path.index_m[h];
+				internal_insert(in, pos, move(sep), child);
+				if (in->size_m <= N) return result;
+				//  N + 1個のキーの中央を親へ移す
+				size_t mid = (N + 1) / 2;
+				internal_type* r = create_internal();
+				Key* p = in->key();
+				for (size_t j = mid + 1; j <= N; ++j) {
+					::new (static_cast<void*>(r->key() + (j - mid - 1))) Key(move(p[j]));
+					p[j].~Key();
+				}
+				for (size_t j = mid + 1; j <= N + 1; ++j) r->child_m[j - mid - 1] = in->child_m[j];
+				r->size_m = N - mid;
+				sep = move(p[mid]);
+				p[mid].~Key();
+				in->size_m = mid;
+				child = r;
+			}
+			//  根が分割されたときは木を高くする
+			internal_type* root = create_internal();
+			::new (static_cast<void*>(root->key())) Key(move(sep));
+			root->child_m[0] = root_m;
+			root->child_m[1] = child;
+			root->size_m = 1;
+			root_m = root;
+			++height_m;
+			return result;
+		}
+		//  要素を削除した葉の不足を兄弟からの移動または併合により解消する
+		void rebalance(leaf_type* leaf, path_type& path) {
+			if (height_m == 1) {
+				if (leaf->size_m == 0) {
+					remove_leaf(leaf);
+					root_m = nullptr;
+					height_m = 0;
+				}
+				return;
+			}
+			if (leaf->size_m >= min_size) return;
+			internal_type* parent = path.node_m[height_m - 2];
+			size_t pos = path.index_m[height_m - 2];
+			//  同じ親を持つ兄弟は連結における前後の葉である
+			leaf_type* left = (pos > 0) ? leaf->prev_m : nullptr;
+			leaf_type* right = (pos < parent->size_m) ? leaf->next_m : nullptr;
+			if ((left != nullptr) && (left->size_m > min_size)) {
+				leaf_insert(leaf, 0, move(left->data()[left->size_m - 1]));
+				allocator_traits<Allocator>::destroy(alloc_m, left->data() + --left->size_m);
+				parent->key()[pos - 1] = leaf->data()[0].first;
+				return;
+			}
+			if ((right != nullptr) && (right->size_m > min_size)) {
+				leaf_insert(leaf, leaf->size_m, move(right->data()[0]));
+				leaf_erase(right, 0);
+				parent->key()[pos] = right->data()[0].first;
+				return;
+			}
+			//  兄弟と併合する(左の葉へ右の葉の要素を移す)
+			if (left == nullptr) {
+				left = leaf;
+				++pos;
+			}
+			else right = leaf;
+			allocator_traits<Allocator>::move_construct(alloc_m, left->data() + left->size_m, left->data() + left->size_m + right->size_m, right->data(), right->data() + right->size_m);
+			allocator_traits<Allocator>::destroy(alloc_m, right->data(), right->data() + right->size_m);
+			left->size_m += right->size_m;
+			remove_leaf(right);
+			internal_erase(parent, pos - 1);
+
+			//  内部ノードの不足を根へ向かって解消する
+			for (size_t h = height_m - 2;; --h) {
+				internal_type* in = path.node_m[h];
+				if (h == 0) {
+					//  根のキーが無くなったときは木を低くする
+					if (in->size_m == 0) {
+						root_m = in->child_m[0];
+						remove_internal(in);
+						--height_m;
+					}
+					return;
+				}
+				if (in->size_m >= min_size) return;
+				parent = path.node_m[h - 1];
+				pos = path.index_m[h - 1];
+				internal_type* l = (pos > 0) ? static_cast<internal_type*>(parent->child_m[pos - 1]) : nullptr;
+				internal_type* r = (pos < parent->size_m) ? static_cast<internal_type*>(parent->child_m[pos + 1]) : nullptr;
+				//  左の兄弟の最後の子を親のキーを介して移す
+				if ((l != nullptr) && (l->size_m > min_size)) {
+					Key* p = in->key();
+					if (in->size_m == 0) ::new (static_cast<void*>(p)) Key(move(parent->key()[pos - 1]));
+					else {
+						::new (static_cast<void*>(p + in->size_m)) Key(move(p[in->size_m - 1]));
+						move_reverse_order(p + 1, p, p + in->size_m - 1);
+						p[0] = move(parent->key()[pos - 1]);
+					}
+					for (size_t j = in->size_m + 1; j > 0; --j) in->child_m[j] = in->child_m[j - 1];
+					in->child_m[0] = l->child_m[l->size_m];
+					++in->size_m;
+					parent->key()[pos - 1] = move(l->key()[l->size_m - 1]);
+					l->key()[--l->size_m].~Key();
+					return;
+				}
+				//  右の兄弟の最初の子を親のキーを介して移す
+				if ((r != nullptr) && (r->size_m > min_size)) {
+					::new (static_cast<void*>(in->key() + in->size_m)) Key(move(parent->key()[pos]));
+					in->child_m[++in->size_m] = r->child_m[0];
+					parent->key()[pos] = move(r->key()[0]);
+					Key* p = r->key();
+					move_order(p, p + 1, p + r->size_m);
+					p[--r->size_m].~Key();
+					for (size_t j = 0; j <= r->size_m; ++j) r->child_m[j] = r->child_m[j + 1];
+					return;
+				}
+				//  兄弟と親のキーを挟んで併合する
+				if (l == nullptr) {
+					l = in;
+					++pos;
+				}
+				else r = in;
+				::new (static_cast<void*>(l->key() + l->size_m)) Key(move(parent->key()[pos - 1]));
+				for (size_t j = 0; j < r->size_m; ++j) {
+					::new (static_cast<void*>(l->key() + l->size_m + 1 + j)) Key(move(r->key()[j]));
+					r->key()[j].~Key();
+				}
+				for (size_t j = 0; j <= r->size_m; ++j) l->child_m[l->size_m + 1 + j] = r->child_m[j];
+				l->size_m += r->size_m + 1;
+				remove_internal(r);
+				internal_erase(parent, pos - 1);
+			}
+		}
+	public:
+		btree_map() : root_m(nullptr), first_m(nullptr), last_m(nullptr), height_m(0), size_m(0), alloc_m() {}
+		explicit btree_map(const Allocator& alloc) : root_m(nullptr), first_m(nullptr), last_m(nullptr), height_m(0), size_m(0)
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)) {}
+		template <class InputIterator>
+		btree_map(InputIterator first, InputIterator last) : btree_map() {
+			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
+
+			for (; first != last; ++first) insert(first->first, first->second);
+		}
+		btree_map(const btree_map& m) : root_m(nullptr), first_m(nullptr), last_m(nullptr), height_m(0), size_m(0)
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(m.alloc_m)) { *this = m; }
+		btree_map(btree_map&& m) : root_m(m.root_m), first_m(m.first_m), last_m(m.last_m), height_m(m.height_m), size_m(m.size_m), alloc_m(m.alloc_m) {
+			m.root_m = nullptr;
+			m.first_m = m.last_m = nullptr;
+			m.height_m = m.size_m = 0;
+		}
+		~btree_map() { clear(); }
+
+		iterator begin() noexcept { return iterator(first_m, 0); }
+		const_iterator begin() const noexcept { return const_iterator(first_m, 0); }
+		iterator end() noexcept { return (last_m == nullptr) ? iterator() : iterator(last_m, last_m->size_m); }
+		const_iterator end() const noexcept { return (last_m == nullptr) ? const_iterator() : const_iterator(last_m, last_m->size_m); }
+
+		void clear() {
+			if (root_m != nullptr) destroy_tree(root_m, height_m);
+			root_m = nullptr;
+			first_m = last_m = nullptr;
+			height_m = 0;
+			size_m = 0;
+		}
+		bool empty() const noexcept { return size_m == 0; }
+		size_type size() const noexcept { return size_m; }
+		size_t height() const noexcept { return height_m; }
+		void swap(btree_map& m) {
+			iml::swap(root_m, m.root_m);
+			iml::swap(first_m, m.first_m);
+			iml::swap(last_m, m.last_m);
+			iml::swap(height_m, m.height_m);
+			iml::swap(size_m, m.size_m);
+			iml::swap(alloc_m, m.alloc_m);
+		}
+		// 内部イテレータ(葉毎に連続した領域を走査する)
+		template <class F>
+		F for_each(F f) const {
+			for (const leaf_type* ptr = first_m; ptr != nullptr; ptr = ptr->next_m)
+				for (const value_type *p = ptr->data(), *last = p + ptr->size_m; p != last; ++p) f(*p);
+			return f;
+		}
+
+		//  key以上となる最初の位置
+		iterator lower_bound(const key_type& key) {
+			if (root_m == nullptr) return end();
+			leaf_type* leaf = find_leaf(key);
+			return leaf_position(leaf, leaf_lower_bound(leaf, key));
+		}
+		const_iterator lower_bound(const key_type& key) const { return const_cast<btree_map*>(this)->lower_bound(key); }
+		//  keyより大きい最初の位置
+		iterator upper_bound(const key_type& key) {
+			iterator itr = lower_bound(key);
+			return ((itr != end()) && !(key < itr->first)) ? ++itr : itr;
+		}
+		const_iterator upper_bound(const key_type& key) const { return const_cast<btree_map*>(this)->upper_bound(key); }
+		//  keyの位置(存在しないときはend())
+		iterator find(const key_type& key) {
+			if (root_m == nullptr) return end();
+			leaf_type* leaf = find_leaf(key);
+			size_t i = leaf_lower_bound(leaf, key);
+			return ((i != leaf->size_m) && !(key < leaf->data()[i].first)) ? iterator(leaf, i) : end();
+		}
+		const_iterator find(const key_type& key) const { return const_cast<btree_map*>(this)->find(key); }
+		bool contains(const key_type& key) const { return find(key) != end(); }
+
+		//  要素の挿入(既に存在するときは値を代入する)
+		iterator insert(const key_type& key, const mapped_type& v = mapped_type()) {
+			if (root_m == nullptr) {
+				root_m = create_leaf(nullptr, nullptr);
+				height_m = 1;
+			}
+			path_type path;
+			leaf_type* leaf = find_leaf(key, &path);
+			size_t i = leaf_lower_bound(leaf, key);
+			if ((i != leaf->size_m) && !(key < leaf->data()[i].first)) {
+				leaf->data()[i].second = v;
+				return iterator(leaf, i);
+			}
+			return insert_new(leaf, i, path, value_type(key, v));
+		}
+		//  要素の削除
+		void erase(const key_type& key) {
+			if (root_m == nullptr) return;
+			path_type path;
+			leaf_type* leaf = find_leaf(key, &path);
+			size_t i = leaf_lower_bound(leaf, key);
+			if ((i == leaf->size_m) || (key < leaf->data()[i].first)) return;
+			leaf_erase(leaf, i);
+			--size_m;
+			rebalance(leaf, path);
+		}
+		//  itrの位置の要素を削除して次の要素の位置を返す
+		iterator erase(const_iterator itr) {
+			Key key = itr->first;
+			erase(key);
+			return lower_bound(key);
+		}
+
+		//  代入
+		btree_map& operator=(const btree_map& m) {
+			if (this == addressof(m)) return *this;
+			clear();
+			//  昇順に末尾へ追加するため葉は満杯に詰められる
+			m.for_each([this](const value_type& v) { insert(v.first, v.second); });
+			return *this;
+		}
+		btree_map& operator=(btree_map&& m) {
+			if (this == addressof(m)) return *this;
+			clear();
+			swap(m);
+			return *this;
+		}
+
+		T& operator[](const Key& key) {
+			iterator itr = lower_bound(key);
+			if ((itr != end()) && !(key < itr->first)) return itr->second;
+			return insert(key, T())->second;
+		}
+	};
+
+
+	//  memory_resourceにより実行時にメモリ確保の方法を切り替えるコンテナ
+	namespace pmr {
+		template <class Key, class T, class Compare = type_comparison<Key>, size_t N = btree_map_default_node_size<pair<Key, T>>>
+		using btree_map = iml::btree_map<Key, T, Compare, N, polymorphic_allocator<pair<Key, T>>>;
+	}
+
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,336 @@
+﻿#ifndef IMATHLIB_CONTAINER_CONCURRENT_MAP_HPP
+#define IMATHLIB_CONTAINER_CONCURRENT_MAP_HPP
+
+#include "IMathLib/container/allocator.hpp"
+#include "IMathLib/container/concurrent_queue.hpp"
+#include "IMathLib/container/memory_resource.hpp"
+#include "IMathLib/utility/tuple.hpp"
+#include <atomic>
+#include <mutex>
+
+
+//  読み取りが大半を占める用途のための並行なスキップリストによる連想配列
+namespace iml {
+
+	//  スキップリストのノード(next_mは高さの分だけ領域の末尾へ延長して確保される)
+	template <class T>
+	struct concurrent_map_node {
+		size_t								level_m;			//  高さ
+		concurrent_map_node*				retired_m;			//  解放待ちのノードの連結
+		alignas(T) unsigned char			data_m[sizeof(T)];
+		std::atomic<concurrent_map_node*>	next_m[1];
+
+		explicit concurrent_map_node(size_t level) : level_m(level), retired_m(nullptr), next_m{} {
+			for (size_t i = 1; i < level; ++i) ::new (static_cast<void*>(next_m + i)) std::atomic<concurrent_map_node*>(nullptr);
+		}
+
+		T* data() noexcept { return reinterpret_cast<T*>(data_m); }
+		const T* data() const noexcept { return reinterpret_cast<const T*>(data_m); }
+	};
+
+
+	//  スキップリストの最下段を辿るイテレータ(readerが存在する間のみ有効)
+	template <class T>
+	struct concurrent_map_iterator {
+		using node_type = concurrent_map_node<remove_const_t<T>>;
+
+		const node_type*	node_m;
+
+		using iterator_category = forward_iterator_tag;
+		using value_type = T;
+		using difference_type = ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		template <class Other>
+		struct rebind {
+			using other = concurrent_map_iterator<Other>;
+		};
+		template <class Other>
+		using rebind_t = concurrent_map_iterator<Other>;
+
+		constexpr concurrent_map_iterator() : node_m(nullptr) {}
+		constexpr explicit concurrent_map_iterator(const node_type* node) : node_m(node) {}
+
+		reference operator*() const { return *node_m->data(); }
+		pointer operator->() const { return node_m->data(); }
+		concurrent_map_iterator& operator++() {
+			node_m = node_m->next_m[0].load(std::memory_order_acquire);
+			return *this;
+		}
+		concurrent_map_iterator operator++(int) { concurrent_map_iterator temp = *this; ++*this; return temp; }
+
+		bool operator==(const concurrent_map_iterator& itr) const { return node_m == itr.node_m; }
+		bool operator!=(const concurrent_map_iterator& itr) const { return node_m != itr.node_m; }
+	};
+
+
+	//  並行なスキップリストによる連想配列
+	//  読み取りはロックフリーであり,書き込みはミューテックスにより直列化される
+	//  書き込みは要素を直接書き換えずにノードを差し替え,外したノードは読み取り中のスレッドが無くなってから解放する(2世代のエポックによる回収)
+	//  readerを保持したまま同一のスレッドで書き込みを行うと回収の待機によりデッドロックとなる
+	//  tree_mapと同様にキーの比較はoperator<による
+	template <class Key, class T, class Compare = type_comparison<Key>, class Allocator = allocator<pair<Key, T>>>
+	class concurrent_map {
+	public:
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = pair<Key, T>;
+		using const_reference = const value_type &;
+		using const_iterator = concurrent_map_iterator<const value_type>;
+		using allocator_type = Allocator;
+		using size_type = typename allocator_traits<Allocator>::size_type;
+
+		static constexpr size_t max_level = 16;				//  スキップリストの段数(各段に1/4の確率で昇格する)
+		static constexpr size_t reclaim_threshold = 64;		//  解放待ちのノードがこの数に達したときに回収する
+	private:
+		using node_type = concurrent_map_node<value_type>;
+		using link_type = std::atomic<node_type*>;
+		using node_allocator = typename allocator_traits<Allocator>::template rebind_t<node_type>;
+
+		//  読み取り中のスレッドの数(スレッド毎に分散して数える)
+		struct alignas(cache_line_size) reader_slot {
+			std::atomic<size_t>		count_m[2];			//  エポックの偶奇毎の数
+		};
+		static constexpr size_t reader_slot_count = 16;
+
+		link_type					head_m[max_level];		//  各段の先頭
+		std::atomic<size_t>			level_m;				//  使用中の段数
+		std::atomic<size_type>		size_m;
+		Allocator					alloc_m;
+
+		mutable reader_slot			slots_m[reader_slot_count];
+		mutable std::atomic<size_t>	epoch_m;
+
+		std::mutex					mtx_m;					//  書き込みの直列化
+		node_type*					retired_m;				//  解放待ちのノード
+		size_t						retired_size_m;
+		unsigned long long			random_m;				//  段数を決めるための乱数の状態
+
+		static size_t slot_index() noexcept {
+			static std::atomic<size_t> next(0);
+			static thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed) % reader_slot_count;
+			return index;
+		}
+		//  読み取りの開始(エポックの偶奇を返す)
+		size_t read_lock(size_t slot) const noexcept {
+			size_t index = epoch_m.load(std::memory_order_relaxed) & 1;
+			slots_m[slot].count_m[index].fetch_add(1, std::memory_order_seq_cst);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			return index;
+		}
+		void read_unlock(size_t slot, size_t index) const noexcept {
+			slots_m[slot].count_m[index].fetch_sub(1, std::memory_order_release);
+		}
+		//  現在読み取り中のスレッドが全て読み取りを終えるまで待機する
+		//  エポックを進めて古い偶奇の読み取りが無くなるのを待つことを2回行い,開始が遅れた読み取りも確実に待つ
+		void synchronize() {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			for (size_t round = 0; round < 2; ++round) {
+				size_t index = epoch_m.fetch_add(1, std::memory_order_seq_cst) & 1;
+				for (size_t i = 0; i < reader_slot_count; ++i)
+					for (size_t count = 0; slots_m[i].count_m[index].load(std::memory_order_seq_cst) != 0; alloc::backoff(count));
+			}
+		}
+
+		//  高さlevelのノードを確保するためのnode_typeの個数
+		static size_t node_units(size_t level) noexcept {
+			return 1 + ((level - 1) * sizeof(link_type) + sizeof(node_type) - 1) / sizeof(node_type);
+		}
+		template <class... Types>
+		node_type* create_node(size_t level, Types&&... args) {
+			node_allocator a(alloc_m);
+			node_type* temp = a.allocate(node_units(level));
+			::new (static_cast<void*>(temp)) node_type(level);
+			//  要素の構築に失敗したときはノードの領域を解放する
+			try { allocator_traits<Allocator>::construct(alloc_m, temp->data(), forward<Types>(args)...); }
+			catch (...) {
+				a.deallocate(temp, node_units(level));
+				throw;
+			}
+			return temp;
+		}
+		void destroy_node(node_type* node) {
+			allocator_traits<Allocator>::destroy(alloc_m, node->data());
+			node_allocator a(alloc_m);
+			a.deallocate(node, node_units(node->level_m));
+		}
+		//  リストから外したノードを解放待ちとする
+		void retire(node_type* node) {
+			node->retired_m = retired_m;
+			retired_m = node;
+			if (++retired_size_m >= reclaim_threshold) reclaim_impl();
+		}
+		void reclaim_impl() {
+			if (retired_m == nullptr) return;
+			synchronize();
+			for (node_type* ptr = retired_m; ptr != nullptr;) {
+				node_type* temp = ptr; ptr = ptr->retired_m;
+				destroy_node(temp);
+			}
+			retired_m = nullptr;
+			retired_size_m = 0;
+		}
+		size_t random_level() noexcept {
+			random_m ^= random_m << 13;
+			random_m ^= random_m >> 7;
+			random_m ^= random_m << 17;
+			size_t level = 1;
+			for (unsigned long long r = random_m; ((r & 3) == 0) && (level < max_level); r >>= 2) ++level;
+			return level;
+		}
+
+		//  各段でkey未満となる最後のリンク(書き込み中のスレッドのみ)
+		void find_preds(const key_type& key, link_type** preds) {
+			link_type* links = head_m;
+			for (size_t lvl = max_level; lvl-- > 0;) {
+				for (node_type* n; ((n = links[lvl].load(std::memory_order_relaxed)) != nullptr) && (n->data()->first < key);) links = n->next_m;
+				preds[lvl] = links;
+			}
+		}
+		//  key以上となる最初のノード(読み取り中のスレッド)
+		const node_type* lower_bound_node(const key_type& key) const {
+			//  リンクは並行して書き換えられるため最下段で読んだノードをそのまま返す
+			const link_type* links = head_m;
+			const node_type* n = nullptr;
+			for (size_t lvl = level_m.load(std::memory_order_acquire); lvl-- > 0;)
+				while (((n = links[lvl].load(std::memory_order_acquire)) != nullptr) && (n->data()->first < key)) links = n->next_m;
+			return n;
+		}
+	public:
+		//  読み取りの区間(保持している間はイテレータと要素への参照が有効となる)
+		class reader {
+			const concurrent_map*	map_m;
+			size_t					slot_m;
+			size_t					index_m;
+		public:
+			explicit reader(const concurrent_map& m) : map_m(addressof(m)), slot_m(slot_index()), index_m(m.read_lock(slot_m)) {}
+			reader(const reader&) = delete;
+			~reader() { map_m->read_unlock(slot_m, index_m); }
+
+			reader& operator=(const reader&) = delete;
+
+			const_iterator begin() const { return const_iterator(map_m->head_m[0].load(std::memory_order_acquire)); }
+			const_iterator end() const { return const_iterator(); }
+			//  key以上となる最初の位置
+			const_iterator lower_bound(const key_type& key) const { return const_iterator(map_m->lower_bound_node(key)); }
+			//  keyの位置(存在しないときはend())
+			const_iterator find(const key_type& key) const {
+				const node_type* n = map_m->lower_bound_node(key);
+				return ((n != nullptr) && !(key < n->data()->first)) ? const_iterator(n) : end();
+			}
+		};
+
+		explicit concurrent_map(const Allocator& alloc = Allocator()) : head_m{}, level_m(1), size_m(0)
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)), slots_m{}, epoch_m(0)
+			, retired_m(nullptr), retired_size_m(0), random_m(0x9E3779B97F4A7C15ull) {}
+		concurrent_map(const concurrent_map&) = delete;
+		//  読み取り中のスレッドが存在しないこと
+		~concurrent_map() {
+			for (node_type* ptr = head_m[0].load(std::memory_order_relaxed); ptr != nullptr;) {
+				node_type* temp = ptr; ptr = ptr->next_m[0].load(std::memory_order_relaxed);
+				destroy_node(temp);
+			}
+			for (node_type* ptr = retired_m; ptr != nullptr;) {
+				node_type* temp = ptr; ptr = ptr->retired_m;
+				destroy_node(temp);
+			}
+		}
+
+		concurrent_map& operator=(const concurrent_map&) = delete;
+
+		//  他のスレッドが書き込み中であれば概算となる
+		size_type size() const noexcept { return size_m.load(std::memory_order_relaxed); }
+		bool empty() const noexcept { return size() == 0; }
+
+		//  keyの要素をvへ複製する(存在しないときはfalse)
+		bool find(const key_type& key, mapped_type& v) const {
+			reader r(*this);
+			const_iterator itr = r.find(key);
+			if (itr == r.end()) return false;
+			v = itr->second;
+			return true;
+		}
+		bool contains(const key_type& key) const {
+			reader r(*this);
+			return r.find(key) != r.end();
+		}
+		// 内部イテレータ
+		template <class F>
+		F for_each(F f) const {
+			reader r(*this);
+			for (const_iterator itr = r.begin(); itr != r.end(); ++itr) f(*itr);
+			return f;
+		}
+		//  キーが[first, last)の範囲の要素を走査する
+		template <class F>
+		F for_each(const key_type& first, const key_type& last, F f) const {
+			reader r(*this);
+			for (const_iterator itr = r.lower_bound(first); (itr != r.end()) && (itr->first < last); ++itr) f(*itr);
+			return f;
+		}
+
+		//  要素の挿入(既に存在するときは値を差し替えたノードで置き換える)
+		void insert(const key_type& key, const mapped_type& v = mapped_type()) {
+			std::lock_guard<std::mutex> lock(mtx_m);
+			link_type* preds[max_level];
+			find_preds(key, preds);
+			node_type* found = preds[0][0].load(std::memory_order_relaxed);
+			if ((found != nullptr) && !(key < found->data()->first)) {
+				node_type* temp = create_node(found->level_m, key, v);
+				for (size_t lvl = 0; lvl < found->level_m; ++lvl) temp->next_m[lvl].store(found->next_m[lvl].load(std::memory_order_relaxed), std::memory_order_relaxed);
+				for (size_t lvl = 0; lvl < found->level_m; ++lvl) preds[lvl][lvl].store(temp, std::memory_order_release);
+				retire(found);
+				return;
+			}
+			size_t level = random_level();
+			node_type* temp = create_node(level, key, v);
+			for (size_t lvl = 0; lvl < level; ++lvl) temp->next_m[lvl].store(preds[lvl][lvl].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			//  下の段から公開する
+			for (size_t lvl = 0; lvl < level; ++lvl) preds[lvl][lvl].store(temp, std::memory_order_release);
+			if (level > level_m.load(std::memory_order_relaxed)) level_m.store(level, std::memory_order_release);
+			size_m.fetch_add(1, std::memory_order_relaxed);
+		}
+		//  要素の削除
+		void erase(const key_type& key) {
+			std::lock_guard<std::mutex> lock(mtx_m);
+			link_type* preds[max_level];
+			find_preds(key, preds);
+			node_type* found = preds[0][0].load(std::memory_order_relaxed);
+			if ((found == nullptr) || (key < found->data()->first)) return;
+			//  上の段から外す(外したノードのnext_mは変更しないため読み取り中のスレッドはそのまま進める)
+			for (size_t lvl = found->level_m; lvl-- > 0;) preds[lvl][lvl].store(found->next_m[lvl].load(std::memory_order_relaxed), std::memory_order_release);
+			size_m.fetch_sub(1, std::memory_order_relaxed);
+			retire(found);
+		}
+		//  全ての要素の削除
+		void clear() {
+			std::lock_guard<std::mutex> lock(mtx_m);
+			node_type* first = head_m[0].load(std::memory_order_relaxed);
+			for (size_t lvl = 0; lvl < max_level; ++lvl) head_m[lvl].store(nullptr, std::memory_order_release);
+			size_m.store(0, std::memory_order_relaxed);
+			for (node_type* ptr = first; ptr != nullptr;) {
+				node_type* temp = ptr; ptr = ptr->next_m[0].load(std::memory_order_relaxed);
+				temp->retired_m = retired_m;
+				retired_m = temp;
+			}
+			reclaim_impl();
+		}
+		//  読み取り中のスレッドが無くなるのを待って解放待ちのノードを解放する
+		void reclaim() {
+			std::lock_guard<std::mutex> lock(mtx_m);
+			reclaim_impl();
+		}
+	};
+
+
+	//  memory_resourceにより実行時にメモリ確保の方法を切り替えるコンテナ
+	namespace pmr {
+		template <class Key, class T, class Compare = type_comparison<Key>>
+		using concurrent_map = iml::concurrent_map<Key, T, Compare, polymorphic_allocator<pair<Key, T>>>;
+	}
+
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,209 @@
+﻿#ifndef IMATHLIB_CONTAINER_CONCURRENT_QUEUE_HPP
+#define IMATHLIB_CONTAINER_CONCURRENT_QUEUE_HPP
+
+#include "IMathLib/container/allocator.hpp"
+#include <atomic>
+#include <thread>
+
+
+//  ロックフリーな有界キュー
+namespace iml {
+
+	//  偽共有を避けるための整列(キャッシュラインのサイズ)
+	inline constexpr size_t cache_line_size = 64;
+
+	namespace alloc {
+		//  size以上の最小の2の冪
+		inline constexpr size_t ceil_pow2(size_t size) {
+			size_t result = 1;
+			while (result < size) result <<= 1;
+			return result;
+		}
+
+		//  待機(しばらくは空回りしてそれ以上はスレッドを譲る)
+		inline void backoff(size_t& count) {
+			if (++count > 64) std::this_thread::yield();
+		}
+	}
+
+
+	//  単一の生産者と単一の消費者の間のキュー(容量は2の冪に切り上げる)
+	template <class T, class Allocator = allocator<T>>
+	class spsc_queue {
+	public:
+		using value_type = T;
+		using allocator_type = Allocator;
+		using size_type = typename allocator_traits<Allocator>::size_type;
+	private:
+		T*			p_m;				//  要素の領域
+		size_type	size_m;				//  容量
+		Allocator	alloc_m;
+
+		//  消費者が書き換える位置と生産者が書き換える位置は別のキャッシュラインに置く
+		alignas(cache_line_size) std::atomic<size_type>	head_m;			//  次に取り出す位置
+		size_type										tail_cache_m;	//  消費者が最後に読んだtail_m
+		alignas(cache_line_size) std::atomic<size_type>	tail_m;			//  次に格納する位置
+		size_type										head_cache_m;	//  生産者が最後に読んだhead_m
+
+		size_type mask() const noexcept { return size_m - 1; }
+	public:
+		explicit spsc_queue(size_type size, const Allocator& alloc = Allocator()) : p_m(nullptr), size_m(alloc::ceil_pow2((iml::max<size_type>)(size, 2)))
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)), head_m(0), tail_cache_m(0), tail_m(0), head_cache_m(0) {
+			p_m = alloc_m.allocate(size_m);
+		}
+		spsc_queue(const spsc_queue&) = delete;
+		~spsc_queue() {
+			for (size_type i = head_m.load(std::memory_order_relaxed), last = tail_m.load(std::memory_order_relaxed); i != last; ++i)
+				allocator_traits<Allocator>::destroy(alloc_m, p_m + (i & mask()));
+			alloc_m.deallocate(p_m, size_m);
+		}
+
+		spsc_queue& operator=(const spsc_queue&) = delete;
+
+		//  生産者のみが呼び出す(満杯のときはfalse)
+		template <class... Types>
+		bool try_emplace(Types&&... args) {
+			size_type tail = tail_m.load(std::memory_order_relaxed);
+			//  満杯に見えるときのみ消費者の位置を読み直す
+			if (tail - head_cache_m == size_m) {
+				head_cache_m = head_m.load(std::memory_order_acquire);
+				if (tail - head_cache_m == size_m) return false;
+			}
+			allocator_traits<Allocator>::construct(alloc_m, p_m + (tail & mask()), forward<Types>(args)...);
+			tail_m.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+		bool try_enqueue(const T& v) { return try_emplace(v); }
+		bool try_enqueue(T&& v) { return try_emplace(move(v)); }
+		//  空きができるまで待機する
+		void enqueue(const T& v) { for (size_t count = 0; !try_emplace(v); alloc::backoff(count)); }
+		void enqueue(T&& v) { for (size_t count = 0; !try_emplace(move(v)); alloc::backoff(count)); }
+
+		//  消費者のみが呼び出す(空のときはfalse)
+		bool try_dequeue(T& v) {
+			size_type head = head_m.load(std::memory_order_relaxed);
+			if (head == tail_cache_m) {
+				tail_cache_m = tail_m.load(std::memory_order_acquire);
+				if (head == tail_cache_m) return false;
+			}
+			T* p = p_m + (head & mask());
+			v = move(*p);
+			allocator_traits<Allocator>::destroy(alloc_m, p);
+			head_m.store(head + 1, std::memory_order_release);
+			return true;
+		}
+		//  要素が格納されるまで待機する
+		void dequeue(T& v) { for (size_t count = 0; !try_dequeue(v); alloc::backoff(count)); }
+
+		//  他方のスレッドが操作中であれば概算となる
+		size_type size() const noexcept { return tail_m.load(std::memory_order_acquire) - head_m.load(std::memory_order_acquire); }
+		bool empty() const noexcept { return size() == 0; }
+		size_type capacity() const noexcept { return size_m; }
+	};
+
+
+	//  複数の生産者と複数の消費者の間のキューの要素(Dmitry Vyukovの有界キュー)
+	template <class T>
+	struct mpmc_queue_cell {
+		std::atomic<size_t>			sequence_m;			//  格納可能なときは位置と等しく取り出し可能なときは位置 + 1
+		alignas(T) unsigned char	data_m[sizeof(T)];
+
+		T* data() noexcept { return reinterpret_cast<T*>(data_m); }
+	};
+
+	//  複数の生産者と複数の消費者の間のキュー(容量は2の冪に切り上げる)
+	template <class T, class Allocator = allocator<mpmc_queue_cell<T>>>
+	class mpmc_queue {
+	public:
+		using value_type = T;
+		using allocator_type = Allocator;
+		using size_type = typename allocator_traits<Allocator>::size_type;
+		using cell_type = mpmc_queue_cell<T>;
+	private:
+		cell_type*	p_m;				//  要素の領域
+		size_type	size_m;				//  容量
+		Allocator	alloc_m;
+
+		alignas(cache_line_size) std::atomic<size_type>	enqueue_pos_m;		//  次に格納する位置
+		alignas(cache_line_size) std::atomic<size_type>	dequeue_pos_m;		//  次に取り出す位置
+
+		size_type mask() const noexcept { return size_m - 1; }
+	public:
+		explicit mpmc_queue(size_type size, const Allocator& alloc = Allocator()) : p_m(nullptr), size_m(alloc::ceil_pow2((iml::max<size_type>)(size, 2)))
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)), enqueue_pos_m(0), dequeue_pos_m(0) {
+			p_m = alloc_m.allocate(size_m);
+			for (size_type i = 0; i < size_m; ++i) ::new (static_cast<void*>(&p_m[i].sequence_m)) std::atomic<size_t>(i);
+		}
+		mpmc_queue(const mpmc_queue&) = delete;
+		~mpmc_queue() {
+			for (size_type i = dequeue_pos_m.load(std::memory_order_relaxed), last = enqueue_pos_m.load(std::memory_order_relaxed); i != last; ++i)
+				allocator_traits<Allocator>::destroy(alloc_m, p_m[i & mask()].data());
+			alloc_m.deallocate(p_m, size_m);
+		}
+
+		mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+		//  満杯のときはfalse
+		template <class... Types>
+		bool try_emplace(Types&&... args) {
+			size_type pos = enqueue_pos_m.load(std::memory_order_relaxed);
+			for (;;) {
+				cell_type& cell = p_m[pos & mask()];
+				size_type seq = cell.sequence_m.load(std::memory_order_acquire);
+				auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+				//  格納可能ならば位置を確保する
+				if (diff == 0) {
+					if (enqueue_pos_m.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						allocator_traits<Allocator>::construct(alloc_m, cell.data(), forward<Types>(args)...);
+						cell.sequence_m.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				//  一周前の要素が取り出されていないため満杯
+				else if (diff < 0) return false;
+				else pos = enqueue_pos_m.load(std::memory_order_relaxed);
+			}
+		}
+		bool try_enqueue(const T& v) { return try_emplace(v); }
+		bool try_enqueue(T&& v) { return try_emplace(move(v)); }
+		//  空きができるまで待機する
+		void enqueue(const T& v) { for (size_t count = 0; !try_emplace(v); alloc::backoff(count)); }
+		void enqueue(T&& v) { for (size_t count = 0; !try_emplace(move(v)); alloc::backoff(count)); }
+
+		//  空のときはfalse
+		bool try_dequeue(T& v) {
+			size_type pos = dequeue_pos_m.load(std::memory_order_relaxed);
+			for (;;) {
+				cell_type& cell = p_m[pos & mask()];
+				size_type seq = cell.sequence_m.load(std::memory_order_acquire);
+				auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos + 1);
+				if (diff == 0) {
+					if (dequeue_pos_m.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						v = move(*cell.data());
+						allocator_traits<Allocator>::destroy(alloc_m, cell.data());
+						//  次の周の生産者へ受け渡す
+						cell.sequence_m.store(pos + size_m, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0) return false;
+				else pos = dequeue_pos_m.load(std::memory_order_relaxed);
+			}
+		}
+		//  要素が格納されるまで待機する
+		void dequeue(T& v) { for (size_t count = 0; !try_dequeue(v); alloc::backoff(count)); }
+
+		//  他のスレッドが操作中であれば概算となる
+		size_type size() const noexcept {
+			size_type first = dequeue_pos_m.load(std::memory_order_relaxed);
+			size_type last = enqueue_pos_m.load(std::memory_order_relaxed);
+			return (last > first) ? last - first : 0;
+		}
+		bool empty() const noexcept { return size() == 0; }
+		size_type capacity() const noexcept { return size_m; }
+	};
+
+}
+
+
+#endif
\ No newline at end of file
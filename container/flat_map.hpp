@@ -0,0 +1,159 @@
+﻿#ifndef IMATHLIB_CONTAINER_FLAT_MAP_HPP
+#define IMATHLIB_CONTAINER_FLAT_MAP_HPP
+
+#include "IMathLib/container/array.hpp"
+#include "IMathLib/utility/tuple.hpp"
+#include <algorithm>
+
+
+//  キーでソートした連続領域による連想配列
+namespace iml {
+
+	//  キーでソートしたpairの動的配列による連想配列(構築後に参照を繰り返す用途のため)
+	//  tree_mapと同様にキーの比較はoperator<による
+	//  要素を詰め直すためにvalue_typeはpair<Key, T>であり,tree_mapとは異なりキーはconstではない
+	//  イテレータやoperator[]を通してキーを書き換えるとソート順が崩れて探索が破綻するため,キーは変更してはならない(値のみ変更できる)
+	template <class Key, class T, class Compare = type_comparison<Key>, class Allocator = allocator<pair<Key, T>>>
+	class flat_map {
+	public:
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = pair<Key, T>;			//  firstは書き換えてはならない
+		using reference = value_type & ;
+		using const_reference = const value_type &;
+		using iterator = array_iterator<value_type>;
+		using const_iterator = array_iterator<const value_type>;
+		using allocator_type = Allocator;
+		using size_type = typename allocator_traits<Allocator>::size_type;
+	private:
+		dynamic_array<value_type, Allocator>	cont_m;
+
+		//  [first, first + n)でkey以上となる最初の位置(分岐を条件付き移動にするため範囲を半分ずつ狭める)
+		static const value_type* lower_bound_impl(const value_type* first, size_type n, const key_type& key) {
+			if (n == 0) return first;
+			while (n > 1) {
+				size_type half = n / 2;
+				first = (first[half].first < key) ? first + half : first;
+				n -= half;
+			}
+			return first + (first->first < key);
+		}
+		value_type* data() noexcept { return (cont_m.size() == 0) ? nullptr : &cont_m[0]; }
+		const value_type* data() const noexcept { return (cont_m.size() == 0) ? nullptr : &cont_m[0]; }
+	public:
+		flat_map() : cont_m() {}
+		explicit flat_map(const Allocator& alloc) : cont_m(alloc) {}
+		template <class InputIterator>
+		flat_map(InputIterator first, InputIterator last) : cont_m() { insert(first, last); }
+		flat_map(const flat_map& m) : cont_m(m.cont_m) {}
+		flat_map(flat_map&& m) : cont_m(move(m.cont_m)) {}
+		~flat_map() {}
+
+		iterator begin() noexcept { return cont_m.begin(); }
+		const_iterator begin() const noexcept { return cont_m.begin(); }
+		iterator end() noexcept { return cont_m.end(); }
+		const_iterator end() const noexcept { return cont_m.end(); }
+
+		void clear() { cont_m.clear(); }
+		bool empty() const noexcept { return cont_m.empty(); }
+		size_type size() const { return cont_m.size(); }
+		size_type capacity() const { return cont_m.capacity(); }
+		void reserve(size_type size) { cont_m.reserve(size); }
+		void shrink_to_fit() { cont_m.shrink_to_fit(); }
+		void swap(flat_map& m) { cont_m.swap(m.cont_m); }
+		// 内部イテレータ
+		template <class F>
+		F for_each(F f) const { return cont_m.for_each(f); }
+
+		//  key以上となる最初の位置
+		iterator lower_bound(const key_type& key) { return iterator(data() + (lower_bound_impl(data(), size(), key) - data())); }
+		const_iterator lower_bound(const key_type& key) const { return const_iterator(lower_bound_impl(data(), size(), key)); }
+		//  keyの位置(存在しないときはend())
+		iterator find(const key_type& key) {
+			iterator itr = lower_bound(key);
+			return ((itr != end()) && !(key < itr->first)) ? itr : end();
+		}
+		const_iterator find(const key_type& key) const {
+			const_iterator itr = lower_bound(key);
+			return ((itr != end()) && !(key < itr->first)) ? itr : end();
+		}
+		bool contains(const key_type& key) const { return find(key) != end(); }
+
+		//  要素の挿入(既に存在するときは値を代入する)
+		iterator insert(const key_type& key, const mapped_type& v = mapped_type()) {
+			size_type pos = lower_bound(key) - begin();
+			if ((pos != size()) && !(key < cont_m[pos].first)) {
+				cont_m[pos].second = v;
+				return begin() + pos;
+			}
+			cont_m.insert(cont_m.begin() + pos, value_type(key, v));
+			return begin() + pos;
+		}
+		//  [first, last)の一括挿入(追加分をソートしてから既存の要素と1度だけマージする)
+		//  同一のキーが複数あるときは後のものが優先される
+		template <class InputIterator>
+		void insert(InputIterator first, InputIterator last) {
+			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
+
+			size_type n = size();
+			cont_m.insert(cont_m.end(), first, last);
+			if (size() == n) return;
+			value_type* p = data();
+			auto less = [](const value_type& a, const value_type& b) { return a.first < b.first; };
+			std::stable_sort(p + n, p + size(), less);
+			//  追加分の重複を除去する(同一のキーは最後のものを残す)
+			size_type m = n;
+			for (size_type i = n; i < size(); ++i) {
+				if ((i + 1 < size()) && !(p[i].first < p[i + 1].first)) continue;
+				if (m != i) p[m] = move(p[i]);
+				++m;
+			}
+			cont_m.erase(cont_m.begin() + m, cont_m.end());
+			//  既存の要素の方が全て小さければマージは不要
+			if ((n == 0) || (p[n - 1].first < p[n].first)) return;
+			dynamic_array<value_type, Allocator> temp(cont_m.get_allocator());
+			temp.reserve(m);
+			for (size_type i = 0, j = n; (i < n) || (j < m);) {
+				if (j == m) temp.emplace_back(move(p[i++]));
+				else if (i == n) temp.emplace_back(move(p[j++]));
+				else if (p[i].first < p[j].first) temp.emplace_back(move(p[i++]));
+				else if (p[j].first < p[i].first) temp.emplace_back(move(p[j++]));
+				else { temp.emplace_back(move(p[j++])); ++i; }
+			}
+			cont_m.swap(temp);
+		}
+		//  要素の削除
+		void erase(const key_type& key) {
+			iterator itr = find(key);
+			if (itr != end()) cont_m.erase(itr);
+		}
+		void erase(const_iterator itr) { cont_m.erase(itr); }
+
+		//  代入
+		flat_map& operator=(const flat_map& m) {
+			cont_m = m.cont_m;
+			return *this;
+		}
+		flat_map& operator=(flat_map&& m) {
+			cont_m = move(m.cont_m);
+			return *this;
+		}
+
+		T& operator[](const Key& key) {
+			iterator itr = lower_bound(key);
+			if ((itr != end()) && !(key < itr->first)) return itr->second;
+			return insert(key, T())->second;
+		}
+	};
+
+
+	//  memory_resourceにより実行時にメモリ確保の方法を切り替えるコンテナ
+	namespace pmr {
+		template <class Key, class T, class Compare = type_comparison<Key>>
+		using flat_map = iml::flat_map<Key, T, Compare, polymorphic_allocator<pair<Key, T>>>;
+	}
+
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,402 @@
+﻿#ifndef IMATHLIB_CONTAINER_HASH_MAP_HPP
+#define IMATHLIB_CONTAINER_HASH_MAP_HPP
+
+#include "IMathLib/container/allocator.hpp"
+#include "IMathLib/container/memory_resource.hpp"
+#include "IMathLib/utility/tuple.hpp"
+#include <functional>
+#include <cstring>
+#include <stdexcept>
+
+
+//  オープンアドレス法によるハッシュテーブルの連想配列
+namespace iml {
+
+	//  ハッシュテーブルのイテレータ(要素の配列と探索距離の配列を空きの位置の次から環状に走査する)
+	//  空きの位置は削除で埋まることがなく,削除時に前へ詰める要素の並びは空きの位置で止まるため走査の終端をまたがない
+	template <class T>
+	struct hash_map_iterator {
+		T*						p_m;			//  要素の配列
+		const unsigned char*	dist_m;			//  要素の探索距離の配列(0は空き)
+		size_t					size_m;			//  容量(0または2の冪)
+		size_t					start_m;		//  走査を開始する位置
+		size_t					pos_m;			//  start_mから走査した位置の数(size_mで終端)
+
+		using iterator_category = forward_iterator_tag;
+		using value_type = T;
+		using difference_type = ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		template <class Other>
+		struct rebind {
+			using other = hash_map_iterator<Other>;
+		};
+		template <class Other>
+		using rebind_t = hash_map_iterator<Other>;
+
+		constexpr hash_map_iterator() : p_m(nullptr), dist_m(nullptr), size_m(0), start_m(0), pos_m(0) {}
+		constexpr hash_map_iterator(T* p, const unsigned char* dist, size_t size, size_t start, size_t pos) : p_m(p), dist_m(dist), size_m(size), start_m(start), pos_m(pos) {}
+		template <class U>
+		constexpr hash_map_iterator(const hash_map_iterator<U>& itr) : p_m(const_cast<T*>(itr.p_m)), dist_m(itr.dist_m), size_m(itr.size_m), start_m(itr.start_m), pos_m(itr.pos_m) {}
+
+		//  指している配列の位置
+		size_t index() const noexcept { return (start_m + pos_m) & (size_m - 1); }
+		//  空きを読み飛ばす
+		hash_map_iterator& skip() {
+			while ((pos_m < size_m) && (dist_m[index()] == 0)) ++pos_m;
+			return *this;
+		}
+
+		reference operator*() const { return p_m[index()]; }
+		pointer operator->() const { return p_m + index(); }
+		hash_map_iterator& operator++() {
+			++pos_m;
+			return skip();
+		}
+		hash_map_iterator operator++(int) { hash_map_iterator temp = *this; ++*this; return temp; }
+
+		bool operator==(const hash_map_iterator& itr) const { return pos_m == itr.pos_m; }
+		bool operator!=(const hash_map_iterator& itr) const { return pos_m != itr.pos_m; }
+	};
+
+
+	//  Robin Hood法によるハッシュテーブルの連想配列
+	//  挿入時は探索距離の短い要素を押し出し,削除時は後続の要素を前に詰めるため削除済みの印(tombstone)を必要としない
+	//  キーの比較はoperator==による
+	template <class Key, class T, class Hash = std::hash<Key>, class Allocator = allocator<pair<Key, T>>>
+	class hash_map {
+	public:
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = pair<Key, T>;
+		using reference = value_type & ;
+		using const_reference = const value_type &;
+		using iterator = hash_map_iterator<value_type>;
+		using const_iterator = hash_map_iterator<const value_type>;
+		using hasher = Hash;
+		using allocator_type = Allocator;
+		using size_type = typename allocator_traits<Allocator>::size_type;
+
+		static constexpr size_type min_capacity = 8;
+	private:
+		using dist_allocator = typename allocator_traits<Allocator>::template rebind_t<unsigned char>;
+
+		static constexpr unsigned char max_dist = 255;			//  探索距離がこれに達したときは再構築する
+
+		value_type*		p_m;			//  要素の領域
+		unsigned char*	dist_m;			//  各位置の探索距離 + 1(0は空き)
+		size_type		size_m;			//  容量(0または2の冪)
+		size_type		use_size_m;		//  要素数
+		size_type		empty_m;		//  空きの位置の1つ(イテレータはこの次から走査する)
+		unsigned int	shift_m;		//  ハッシュ値から位置を得るためのシフト量
+		Hash			hash_m;
+		Allocator		alloc_m;
+
+		//  ハッシュ値を攪拌して上位ビットから位置を得る(恒等写像のハッシュ関数でも偏らないようにする)
+		size_type index(size_t h) const noexcept { return static_cast<size_type>((static_cast<unsigned long long>(h) * 0x9E3779B97F4A7C15ull) >> shift_m); }
+		//  最大負荷率(7/8)を超えずに格納できる要素数
+		static constexpr size_type max_load(size_type size) { return size - size / 8; }
+
+		//  容量sizeの領域を確保して全て空きにする
+		void allocate(size_type size) {
+			dist_allocator a(alloc_m);
+			value_type* p = alloc_m.allocate(size);
+			try { dist_m = a.allocate(size); }
+			catch (...) {
+				alloc_m.deallocate(p, size);
+				throw;
+			}
+			p_m = p;
+			std::memset(dist_m, 0, size);
+			size_m = size;
+			empty_m = 0;
+			shift_m = 64;
+			for (size_type n = size; n > 1; n >>= 1) --shift_m;
+		}
+		void deallocate() {
+			if (size_m == 0) return;
+			dist_allocator a(alloc_m);
+			alloc_m.deallocate(p_m, size_m);
+			a.deallocate(dist_m, size_m);
+			p_m = nullptr;
+			dist_m = nullptr;
+			size_m = 0;
+		}
+		void destroy_all() {
+			for (size_type i = 0; i < size_m; ++i)
+				if (dist_m[i] != 0) {
+					allocator_traits<Allocator>::destroy(alloc_m, p_m + i);
+					dist_m[i] = 0;
+				}
+			use_size_m = 0;
+		}
+		//  keyの位置(存在しないときはsize_m)
+		size_type find_index(const key_type& key) const {
+			if (use_size_m == 0) return size_m;
+			size_type mask = size_m - 1;
+			size_type i = index(hash_m(key));
+			//  既存の要素の探索距離の方が短くなった時点で存在しないことが確定する
+			for (unsigned char d = 1; d <= dist_m[i]; ++d, i = (i + 1) & mask)
+				if ((d == dist_m[i]) && (p_m[i].first == key)) return i;
+			return size_m;
+		}
+		//  位置iから挿入したときに押し出される要素も含めて探索距離が上限に収まるか(領域は変更しない)
+		bool probe_fits(size_type i) const noexcept {
+			size_type mask = size_m - 1;
+			for (unsigned char d = 1; dist_m[i] != 0; i = (i + 1) & mask) {
+				if (dist_m[i] < d) d = dist_m[i];
+				if (++d == max_dist) return false;
+			}
+			return true;
+		}
+		//  位置iから要素を挿入してその位置を返す(探索距離が上限に収まることは確認済みとする)
+		size_type place(size_type i, value_type&& v) {
+			size_type mask = size_m - 1;
+			size_type result = size_m;
+			for (unsigned char d = 1;; ++d, i = (i + 1) & mask) {
+				if (dist_m[i] == 0) {
+					allocator_traits<Allocator>::construct(alloc_m, p_m + i, move(v));
+					dist_m[i] = d;
+					++use_size_m;
+					//  走査の起点とする空きの位置を埋めたときは次の空きを探す(負荷率の上限により空きは必ず存在する)
+					while (dist_m[empty_m] != 0) empty_m = (empty_m + 1) & mask;
+					return (result == size_m) ? i : result;
+				}
+				//  探索距離の短い要素を押し出して代わりに持ち運ぶ
+				if (dist_m[i] < d) {
+					iml::swap(p_m[i], v);
+					iml::swap(dist_m[i], d);
+					if (result == size_m) result = i;
+				}
+			}
+		}
+		//  存在しないキーの要素を挿入してその位置を返す(探索距離が上限に達するときは先に再構築する)
+		size_type insert_unique(value_type&& v) {
+			size_type i = index(hash_m(v.first));
+			while (!probe_fits(i)) {
+				//  負荷率が低いにも関わらず上限に達するときはハッシュ関数が偏っているため拡張しても解消しない
+				if (use_size_m < size_m / 4) throw std::length_error("probe length exceeds limit.");
+				rehash(size_m * 2);
+				i = index(hash_m(v.first));
+			}
+			return place(i, move(v));
+		}
+		//  空の領域へ[p, p + size)の要素を配置したときに全ての探索距離が上限に収まるか(探索距離の配列のみで模擬して空に戻す)
+		bool placement_fits(const value_type* p, const unsigned char* dist, size_type size) {
+			size_type mask = size_m - 1;
+			bool result = true;
+			for (size_type k = 0; (k < size) && result; ++k) {
+				if (dist[k] == 0) continue;
+				size_type i = index(hash_m(p[k].first));
+				for (unsigned char d = 1;; i = (i + 1) & mask) {
+					if (dist_m[i] == 0) {
+						dist_m[i] = d;
+						break;
+					}
+					if (dist_m[i] < d) iml::swap(dist_m[i], d);
+					if (++d == max_dist) {
+						result = false;
+						break;
+					}
+				}
+			}
+			std::memset(dist_m, 0, size_m);
+			return result;
+		}
+		//  容量をsize以上の2の冪にして全ての要素を再配置する
+		//  再配置の途中で探索距離が上限に達しないよう,要素を移す前に収まる容量まで拡張する
+		void rehash(size_type size) {
+			size_type n = min_capacity;
+			while ((n < size) || (max_load(n) < use_size_m)) n <<= 1;
+			value_type* p = p_m;
+			unsigned char* dist = dist_m;
+			size_type old_size = size_m;
+			unsigned int old_shift = shift_m;
+			size_type old_empty = empty_m;
+			try {
+				for (allocate(n); !placement_fits(p, dist, old_size); allocate(n)) {
+					deallocate();
+					n <<= 1;
+				}
+			}
+			catch (...) {
+				//  確保やハッシュ関数の例外では元の領域のまま
+				if (p_m != p) deallocate();
+				p_m = p;
+				dist_m = dist;
+				size_m = old_size;
+				shift_m = old_shift;
+				empty_m = old_empty;
+				throw;
+			}
+			use_size_m = 0;
+			for (size_type i = 0; i < old_size; ++i)
+				if (dist[i] != 0) {
+					place(index(hash_m(p[i].first)), move(p[i]));
+					allocator_traits<Allocator>::destroy(alloc_m, p + i);
+				}
+			if (old_size != 0) {
+				dist_allocator a(alloc_m);
+				alloc_m.deallocate(p, old_size);
+				a.deallocate(dist, old_size);
+			}
+		}
+		//  要素を1つ追加できるようにする
+		void grow() {
+			if (use_size_m + 1 > max_load(size_m)) rehash((size_m == 0) ? min_capacity : size_m * 2);
+		}
+		//  位置iの要素を削除して後続の要素を前に詰める
+		void erase_index(size_type i) {
+			size_type mask = size_m - 1;
+			allocator_traits<Allocator>::destroy(alloc_m, p_m + i);
+			for (size_type j = (i + 1) & mask; dist_m[j] > 1; i = j, j = (j + 1) & mask) {
+				allocator_traits<Allocator>::construct(alloc_m, p_m + i, move(p_m[j]));
+				allocator_traits<Allocator>::destroy(alloc_m, p_m + j);
+				dist_m[i] = dist_m[j] - 1;
+			}
+			dist_m[i] = 0;
+			--use_size_m;
+		}
+		//  走査を開始する位置
+		size_type start_index() const noexcept { return (size_m == 0) ? 0 : (empty_m + 1) & (size_m - 1); }
+		//  位置iを指すイテレータ
+		iterator make_iterator(size_type i) noexcept { return iterator(p_m, dist_m, size_m, start_index(), (i - start_index()) & (size_m - 1)); }
+		const_iterator make_iterator(size_type i) const noexcept { return const_iterator(p_m, dist_m, size_m, start_index(), (i - start_index()) & (size_m - 1)); }
+	public:
+		hash_map() : p_m(nullptr), dist_m(nullptr), size_m(0), use_size_m(0), empty_m(0), shift_m(64), hash_m(), alloc_m() {}
+		explicit hash_map(const Allocator& alloc) : p_m(nullptr), dist_m(nullptr), size_m(0), use_size_m(0), empty_m(0), shift_m(64), hash_m()
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)) {}
+		explicit hash_map(size_type size, const Hash& hash = Hash(), const Allocator& alloc = Allocator()) : p_m(nullptr), dist_m(nullptr), size_m(0), use_size_m(0), empty_m(0), shift_m(64), hash_m(hash)
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)) { reserve(size); }
+		template <class InputIterator>
+		hash_map(InputIterator first, InputIterator last) : hash_map() {
+			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
+
+			for (; first != last; ++first) insert(first->first, first->second);
+		}
+		hash_map(const hash_map& m) : p_m(nullptr), dist_m(nullptr), size_m(0), use_size_m(0), empty_m(0), shift_m(64), hash_m(m.hash_m)
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(m.alloc_m)) { *this = m; }
+		hash_map(hash_map&& m) : p_m(m.p_m), dist_m(m.dist_m), size_m(m.size_m), use_size_m(m.use_size_m), empty_m(m.empty_m), shift_m(m.shift_m), hash_m(m.hash_m), alloc_m(m.alloc_m) {
+			m.p_m = nullptr;
+			m.dist_m = nullptr;
+			m.size_m = m.use_size_m = 0;
+		}
+		~hash_map() {
+			destroy_all();
+			deallocate();
+		}
+
+		iterator begin() noexcept { return iterator(p_m, dist_m, size_m, start_index(), 0).skip(); }
+		const_iterator begin() const noexcept { return const_iterator(p_m, dist_m, size_m, start_index(), 0).skip(); }
+		iterator end() noexcept { return iterator(p_m, dist_m, size_m, start_index(), size_m); }
+		const_iterator end() const noexcept { return const_iterator(p_m, dist_m, size_m, start_index(), size_m); }
+
+		//  全ての要素の削除(領域は保持する)
+		void clear() { destroy_all(); }
+		bool empty() const noexcept { return use_size_m == 0; }
+		size_type size() const noexcept { return use_size_m; }
+		size_type capacity() const noexcept { return size_m; }
+		float load_factor() const noexcept { return (size_m == 0) ? 0.f : static_cast<float>(use_size_m) / size_m; }
+		//  size個の要素を再構築せずに格納できるようにする
+		void reserve(size_type size) {
+			if (size <= max_load(size_m)) return;
+			size_type n = min_capacity;
+			while (max_load(n) < size) n <<= 1;
+			rehash(n);
+		}
+		void swap(hash_map& m) {
+			iml::swap(p_m, m.p_m);
+			iml::swap(dist_m, m.dist_m);
+			iml::swap(size_m, m.size_m);
+			iml::swap(use_size_m, m.use_size_m);
+			iml::swap(empty_m, m.empty_m);
+			iml::swap(shift_m, m.shift_m);
+			iml::swap(hash_m, m.hash_m);
+			iml::swap(alloc_m, m.alloc_m);
+		}
+		// 内部イテレータ
+		template <class F>
+		F for_each(F f) const {
+			for (size_type i = 0; i < size_m; ++i) if (dist_m[i] != 0) f(static_cast<const value_type&>(p_m[i]));
+			return f;
+		}
+		hasher hash_function() const { return hash_m; }
+
+		//  keyの位置(存在しないときはend())
+		iterator find(const key_type& key) {
+			size_type i = find_index(key);
+			return (i == size_m) ? end() : make_iterator(i);
+		}
+		const_iterator find(const key_type& key) const {
+			size_type i = find_index(key);
+			return (i == size_m) ? end() : make_iterator(i);
+		}
+		bool contains(const key_type& key) const { return find_index(key) != size_m; }
+
+		//  要素の挿入(既に存在するときは値を代入する)
+		iterator insert(const key_type& key, const mapped_type& v = mapped_type()) {
+			size_type i = find_index(key);
+			if (i != size_m) {
+				p_m[i].second = v;
+				return make_iterator(i);
+			}
+			grow();
+			i = insert_unique(value_type(key, v));
+			return make_iterator(i);
+		}
+		//  要素の削除
+		void erase(const key_type& key) {
+			size_type i = find_index(key);
+			if (i != size_m) erase_index(i);
+		}
+		//  itrの位置の要素を削除して次の位置を返す(後続の未走査の要素が詰められるためitrの位置から走査を続けられる)
+		iterator erase(const_iterator itr) {
+			erase_index(itr.index());
+			return iterator(p_m, dist_m, size_m, itr.start_m, itr.pos_m).skip();
+		}
+
+		//  代入(同一の容量で配置も複製する)
+		hash_map& operator=(const hash_map& m) {
+			if (this == addressof(m)) return *this;
+			destroy_all();
+			if (size_m != m.size_m) {
+				deallocate();
+				if (m.size_m != 0) allocate(m.size_m);
+			}
+			for (size_type i = 0; i < m.size_m; ++i)
+				if (m.dist_m[i] != 0) {
+					allocator_traits<Allocator>::construct(alloc_m, p_m + i, m.p_m[i]);
+					dist_m[i] = m.dist_m[i];
+				}
+			use_size_m = m.use_size_m;
+			empty_m = m.empty_m;
+			hash_m = m.hash_m;
+			return *this;
+		}
+		hash_map& operator=(hash_map&& m) {
+			if (this == addressof(m)) return *this;
+			destroy_all();
+			deallocate();
+			swap(m);
+			return *this;
+		}
+
+		T& operator[](const Key& key) {
+			size_type i = find_index(key);
+			if (i != size_m) return p_m[i].second;
+			return insert(key, T())->second;
+		}
+	};
+
+
+	//  memory_resourceにより実行時にメモリ確保の方法を切り替えるコンテナ
+	namespace pmr {
+		template <class Key, class T, class Hash = std::hash<Key>>
+		using hash_map = iml::hash_map<Key, T, Hash, polymorphic_allocator<pair<Key, T>>>;
+	}
+
+}
+
+
+#endif
\ No newline at end of file
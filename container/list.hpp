@@ -327,6 +327,13 @@ namespace iml {
 		const T& back() const { return last_m->value_m; }
 	};
 
+
+	//  memory_resourceにより実行時にメモリ確保の方法を切り替えるコンテナ
+	namespace pmr {
+		template <class T>
+		using list = iml::list<T, polymorphic_allocator<list_node<T>>>;
+	}
+
 }
 
 
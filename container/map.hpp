@@ -2,6 +2,7 @@
 #define IMATHLIB_CONTAINER_MAP_HPP
 
 #include "IMathLib/container/allocator.hpp"
+#include "IMathLib/container/memory_resource.hpp"
 #include "IMathLib/utility/algorithm.hpp"
 #include "IMathLib/utility/tuple.hpp"
 
@@ -541,8 +542,42 @@ namespace iml {
 			if (n->right != nullptr) _For_each(n->right, f);
 			return f;
 		}
+		//  部分木nのノードを中間順にrightで連結したリストにする(tailは末尾のrightへのポインタ)
+		static void _Flatten(_Node* n, _Node**& tail) {
+			if (n == nullptr) return;
+			_Node* right = n->right;
+			_Flatten(n->left, tail);
+			*tail = n;
+			tail = &n->right;
+			_Flatten(right, tail);
+		}
+		//  リストの先頭からn個のノードで平衡な部分木を構築する(深さがred_depthのノードのみ赤とする)
+		static _Node* _Build(_Node*& list, size_type n, size_type depth, size_type red_depth) {
+			if (n == 0) return nullptr;
+			size_type left_size = (n - 1) / 2;
+			_Node* left = _Build(list, left_size, depth + 1, red_depth);
+			_Node* temp = list;
+			list = list->right;
+			temp->left = left;
+			if (left != nullptr) left->parent = temp;
+			temp->right = _Build(list, n - left_size - 1, depth + 1, red_depth);
+			if (temp->right != nullptr) temp->right->parent = temp;
+			temp->flag = (depth == red_depth);
+			return temp;
+		}
+		//  整列済みのn個のノードのリストから木を構築してその根を返す
+		//  左右の部分木の大きさの差を高々1とするため葉は最も深い2つの段にのみ存在し,最も深い段を赤とすれば赤黒木の条件を満たす
+		static _Node* _Build_root(_Node* list, size_type n) {
+			if (n == 0) return nullptr;
+			size_type depth = 0;
+			while ((static_cast<size_type>(2) << depth) <= n) ++depth;
+			_Node* result = _Build(list, n, 0, (depth == 0) ? 1 : depth);
+			result->parent = nullptr;
+			return result;
+		}
 	public:
 		tree_map_container() {}
+		explicit tree_map_container(const Allocator& alloc) : _allo(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)) {}
 		virtual ~tree_map_container() = 0 {}
 
 		virtual iterator begin() noexcept = 0;
@@ -556,6 +591,122 @@ namespace iml {
 			_size = 0;
 			allocator_traits<Allocator>::destroy(_allo, root);
 			_allo.deallocate(root, 1);
+			root = nullptr;
+		}
+
+		//  キーの昇順に整列した[first, last)で置き換える(回転を行わずにO(n)で平衡な木を構築する)
+		//  同一のキーが続くときは後のものが優先され,整列していない要素が現れたときは以降を通常の挿入で行う
+		template <class InputIterator>
+		void assign_sorted(InputIterator first, InputIterator last) {
+			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
+
+			clear();
+			_Node* head = nullptr;
+			_Node** tail = &head;
+			_Node* prev = nullptr;
+			try {
+				for (; first != last; ++first) {
+					if (prev != nullptr) {
+						if (first->first < prev->value.first) break;
+						if (!(prev->value.first < first->first)) {
+							prev->value.second = first->second;
+							continue;
+						}
+					}
+					prev = _allo.allocate(1);
+					try { allocator_traits<Allocator>::construct(_allo, prev, first->first, first->second, nullptr); }
+					catch (...) {
+						_allo.deallocate(prev, 1);
+						throw;
+					}
+					*tail = prev;
+					tail = &prev->right;
+					++_size;
+				}
+			}
+			catch (...) {
+				//  構築済みのノードで木を構築してから再送出する
+				*tail = nullptr;
+				root = _Build_root(head, _size);
+				throw;
+			}
+			*tail = nullptr;
+			root = _Build_root(head, _size);
+			for (; first != last; ++first) insert(first->first, first->second);
+		}
+		//  mの要素を移す(ノードを付け替えるため要素の複製や確保は行わない)
+		//  既に存在するキーの要素はmに残り,双方を中間順のリストとしてマージしてから木を構築し直すためO(n + m)となる
+		//  アロケータが等しくないときはノードを付け替えられないため,要素を複製して挿入しmのノードを解放する
+		void merge(tree_map_container& m) {
+			if ((this == addressof(m)) || (m.root == nullptr)) return;
+			if (!(_allo == m._allo)) {
+				_Node* b = nullptr;
+				_Node** b_tail = &b;
+				_Flatten(m.root, b_tail);
+				*b_tail = nullptr;
+				_Node* rest = nullptr;
+				_Node** rest_tail = &rest;
+				size_type rest_n = 0;
+				try {
+					for (; b != nullptr;) {
+						//  重複したmのノードはmに残す
+						if (find(b->value.first) != nullptr) {
+							*rest_tail = b;
+							rest_tail = &b->right;
+							b = b->right;
+							++rest_n;
+							continue;
+						}
+						insert(b->value.first, b->value.second);
+						_Node* temp = b;
+						b = b->right;
+						allocator_traits<Allocator>::destroy(m._allo, temp);
+						m._allo.deallocate(temp, 1);
+					}
+				}
+				catch (...) {
+					//  移していないノードをmに戻す
+					*rest_tail = b;
+					for (; b != nullptr; b = b->right) ++rest_n;
+					m.root = _Build_root(rest, rest_n);
+					m._size = rest_n;
+					throw;
+				}
+				*rest_tail = nullptr;
+				m.root = _Build_root(rest, rest_n);
+				m._size = rest_n;
+				return;
+			}
+			_Node *a = nullptr, *b = nullptr;
+			_Node **a_tail = &a, **b_tail = &b;
+			_Flatten(root, a_tail);
+			_Flatten(m.root, b_tail);
+			*a_tail = *b_tail = nullptr;
+
+			_Node *head = nullptr, *rest = nullptr;
+			_Node **tail = &head, **rest_tail = &rest;
+			size_type n = 0, rest_n = 0;
+			while ((a != nullptr) || (b != nullptr)) {
+				_Node* temp;
+				if ((b == nullptr) || ((a != nullptr) && (a->value.first < b->value.first))) { temp = a; a = a->right; }
+				else if ((a == nullptr) || (b->value.first < a->value.first)) { temp = b; b = b->right; }
+				//  重複したmのノードはmに残す
+				else {
+					*rest_tail = b;
+					rest_tail = &b->right;
+					b = b->right;
+					++rest_n;
+					continue;
+				}
+				*tail = temp;
+				tail = &temp->right;
+				++n;
+			}
+			*tail = *rest_tail = nullptr;
+			root = _Build_root(head, n);
+			_size = n;
+			m.root = _Build_root(rest, rest_n);
+			m._size = rest_n;
 		}
 
 		_Node* insert(const key_type& key, const mapped_type& v = mapped_type()) {
@@ -584,6 +735,10 @@ namespace iml {
 		void erase(const key_type& key) {
 			_Node* temp = _Erase(find(key));
 			if (temp != nullptr) {
+				//  削除や回転により根が変わる可能性があるため残ったノードから辿り直す
+				_Node* r = (temp->parent != nullptr) ? temp->parent : ((temp->left != nullptr) ? temp->left : temp->right);
+				if (r != nullptr) while (r->parent != nullptr) r = r->parent;
+				root = r;
 				allocator_traits<Allocator>::destroy(_allo, temp);
 				_allo.deallocate(temp, 1);
 				--_size;
@@ -612,17 +767,19 @@ namespace iml {
 		using typename tree_map_container<pair<const Key, T>, Compare, Allocator>::size_type;
 
 		using typename tree_map_container<pair<const Key, T>, Compare, Allocator>::_Node;
-	private:
-		//  代入の補助関数
-		void substitution_support(_Node* n1, _Node* n2) {
-			if (n2 == nullptr) return;
-			n1 = _allo.allocate(1);
-			allocator_traits<Allocator>::construct(_allo, n1, *n2);
-			if (n->left != nullptr) substitution_support(n1->left, n2->left);
-			if (n->right != nullptr) substitution_support(n1->right, n2->right);
-		}
+	protected:
+		using tree_map_container<pair<const Key, T>, Compare, Allocator>::_allo;
+		using tree_map_container<pair<const Key, T>, Compare, Allocator>::_size;
+		using tree_map_container<pair<const Key, T>, Compare, Allocator>::root;
 	public:
+		using tree_map_container<pair<const Key, T>, Compare, Allocator>::clear;
+		using tree_map_container<pair<const Key, T>, Compare, Allocator>::find;
+		using tree_map_container<pair<const Key, T>, Compare, Allocator>::insert;
+
 		constexpr tree_map() {}
+		explicit tree_map(const Allocator& alloc) : tree_map_container<pair<const Key, T>, Compare, Allocator>(alloc) {}
+		tree_map(const tree_map& s) : tree_map_container<pair<const Key, T>, Compare, Allocator>(s._allo) { *this = s; }
+		tree_map(tree_map&& s) : tree_map_container<pair<const Key, T>, Compare, Allocator>(s._allo) { *this = move(s); }
 		~tree_map() { clear(); }
 
 		//  イテレータ位置の取得
@@ -643,20 +800,32 @@ namespace iml {
 
 		bool empty() const noexcept { return _size == 0; }
 
-		//  代入
+		//  代入(中間順に複製したノードの列から平衡な木を構築する)
 		tree_map& operator=(const tree_map& s) {
-			if (s._p == this->_p) return *this;
-			this->_allo = s._allo;
-			this->_size = s._size;
-			this->clear();
-			substitution_support(this->root, s.root);
+			if (this == addressof(s)) return *this;
+			clear();
+			_allo = s._allo;
+			_Node* head = nullptr;
+			_Node** tail = &head;
+			if (s.root != nullptr) s.for_each([&](const value_type& v) {
+				_Node* temp = _allo.allocate(1);
+				allocator_traits<Allocator>::construct(_allo, temp, v.first, v.second, nullptr);
+				*tail = temp;
+				tail = &temp->right;
+			});
+			*tail = nullptr;
+			root = this->_Build_root(head, s._size);
+			_size = s._size;
 			return *this;
 		}
 		tree_map& operator=(tree_map&& s) {
-			if (s._p == this->_p) return *this;
-			this->_allo = s._allo;
-			this->_size = s._size;
-			this->root = s.root;
+			if (this == addressof(s)) return *this;
+			clear();
+			_allo = s._allo;
+			_size = s._size;
+			root = s.root;
+			s.root = nullptr;
+			s._size = 0;
 			return *this;
 		}
 
@@ -667,6 +836,13 @@ namespace iml {
 		}
 	};
 
+
+	//  memory_resourceにより実行時にメモリ確保の方法を切り替えるコンテナ
+	namespace pmr {
+		template <class Key, class T, class Compare = type_comparison<Key>>
+		using tree_map = iml::tree_map<Key, T, Compare, polymorphic_allocator<typename tree_map_iterator<pair<const Key, T>>::node>>;
+	}
+
 }
 
 
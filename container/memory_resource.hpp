@@ -0,0 +1,222 @@
+﻿#ifndef IMATHLIB_CONTAINER_MEMORY_RESOURCE_HPP
+#define IMATHLIB_CONTAINER_MEMORY_RESOURCE_HPP
+
+#include "IMathLib/container/allocator.hpp"
+#include <atomic>
+
+
+//  実行時に切り替え可能なメモリ資源と多相アロケータ
+namespace iml {
+
+	namespace alloc {
+		//  ::operator newによるメモリ資源
+		class new_delete_resource_impl : public memory_resource {
+			void* do_allocate(size_t size, size_t align) {
+				if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator new(size, std::align_val_t(align));
+				return ::operator new(size);
+			}
+			void do_deallocate(void* p, size_t, size_t align) {
+				if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(p, std::align_val_t(align));
+				else ::operator delete(p);
+			}
+			bool do_is_equal(const memory_resource& r) const noexcept { return this == &r; }
+		};
+		//  常に確保に失敗するメモリ資源
+		class null_memory_resource_impl : public memory_resource {
+			void* do_allocate(size_t, size_t) { throw std::bad_alloc(); }
+			void do_deallocate(void*, size_t, size_t) {}
+			bool do_is_equal(const memory_resource& r) const noexcept { return this == &r; }
+		};
+
+		inline std::atomic<memory_resource*>& default_resource() noexcept {
+			static std::atomic<memory_resource*> r(nullptr);
+			return r;
+		}
+	}
+
+	//  ::operator newによるメモリ資源
+	inline memory_resource* new_delete_resource() noexcept {
+		static alloc::new_delete_resource_impl r;
+		return &r;
+	}
+	//  常に確保に失敗するメモリ資源(上流への確保を禁止するため)
+	inline memory_resource* null_memory_resource() noexcept {
+		static alloc::null_memory_resource_impl r;
+		return &r;
+	}
+	//  既定のメモリ資源の取得と設定(未設定のときはnew_delete_resource())
+	inline memory_resource* get_default_resource() noexcept {
+		memory_resource* r = alloc::default_resource().load(std::memory_order_acquire);
+		return (r != nullptr) ? r : new_delete_resource();
+	}
+	inline memory_resource* set_default_resource(memory_resource* r) noexcept {
+		memory_resource* temp = alloc::default_resource().exchange(r, std::memory_order_acq_rel);
+		return (temp != nullptr) ? temp : new_delete_resource();
+	}
+
+
+	//  monotonic_arenaによるメモリ資源(解放はrelease()で一括して行う)
+	class monotonic_buffer_resource : public memory_resource {
+		monotonic_arena		arena_m;
+		memory_resource*	upstream_m;
+
+		void* do_allocate(size_t size, size_t align) { return arena_m.allocate(size, align); }
+		void do_deallocate(void*, size_t, size_t) {}
+		bool do_is_equal(const memory_resource& r) const noexcept { return this == &r; }
+	public:
+		explicit monotonic_buffer_resource(memory_resource* upstream = get_default_resource()) : arena_m(4096, upstream), upstream_m(upstream) {}
+		monotonic_buffer_resource(size_t initial_size, memory_resource* upstream = get_default_resource()) : arena_m(initial_size, upstream), upstream_m(upstream) {}
+		monotonic_buffer_resource(void* buffer, size_t size, memory_resource* upstream = get_default_resource()) : arena_m(buffer, size, upstream), upstream_m(upstream) {}
+		monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+		~monotonic_buffer_resource() {}
+
+		monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+		//  確保した領域を全て無効にしてチャンクを再利用する
+		void reset() noexcept { arena_m.reset(); }
+		//  チャンクを全て上流へ返却する
+		void release() noexcept { arena_m.release(); }
+
+		memory_resource* upstream_resource() const noexcept { return upstream_m; }
+	};
+
+
+	//  サイズ毎の空きリストによるメモリ資源(スレッドセーフではない)
+	class unsynchronized_pool_resource : public memory_resource {
+		static constexpr size_t min_block_size = 8;
+		static constexpr size_t pool_count = 10;				//  8, 16, ..., 4096バイトのブロック
+		static constexpr size_t max_block_size = min_block_size << (pool_count - 1);
+
+		struct block {
+			block*	next_m;
+		};
+		//  上流から確保したチャンクのヘッダ
+		struct alignas(max_align_t) chunk {
+			chunk*	next_m;
+			size_t	size_m;				//  ヘッダを含めたサイズ
+		};
+
+		memory_resource*	upstream_m;
+		chunk*				chunks_m;
+		block*				free_m[pool_count];
+		size_t				blocks_per_chunk_m[pool_count];		//  次のチャンクで確保するブロック数
+
+		//  sizeバイトを格納するプールの番号
+		static constexpr size_t pool_index(size_t size) {
+			size_t result = 0;
+			for (size_t n = min_block_size; n < size; n <<= 1) ++result;
+			return result;
+		}
+		static constexpr size_t block_size(size_t index) { return min_block_size << index; }
+
+		//  index番目のプールへチャンクを補充する
+		void refill(size_t index) {
+			size_t n = blocks_per_chunk_m[index];
+			size_t size = block_size(index);
+			chunk* temp = static_cast<chunk*>(upstream_m->allocate(sizeof(chunk) + size * n, alignof(chunk)));
+			temp->next_m = chunks_m;
+			temp->size_m = sizeof(chunk) + size * n;
+			chunks_m = temp;
+			unsigned char* p = reinterpret_cast<unsigned char*>(temp + 1);
+			for (size_t i = 0; i < n; ++i) {
+				block* b = reinterpret_cast<block*>(p + size * i);
+				b->next_m = (i + 1 < n) ? reinterpret_cast<block*>(p + size * (i + 1)) : free_m[index];
+			}
+			free_m[index] = reinterpret_cast<block*>(p);
+			//  次回は倍の数を確保する(1チャンクあたり64KB程度まで)
+			if (size * n * 2 <= 65536) blocks_per_chunk_m[index] = n * 2;
+		}
+
+		void* do_allocate(size_t size, size_t align) {
+			//  大きな領域と過剰な整列は上流へ直接要求する
+			if ((size > max_block_size) || (align > alignof(max_align_t))) return upstream_m->allocate(size, align);
+			size_t index = pool_index((iml::max)(size, align));
+			if (free_m[index] == nullptr) refill(index);
+			block* temp = free_m[index];
+			free_m[index] = temp->next_m;
+			return temp;
+		}
+		void do_deallocate(void* p, size_t size, size_t align) {
+			if ((size > max_block_size) || (align > alignof(max_align_t))) { upstream_m->deallocate(p, size, align); return; }
+			size_t index = pool_index((iml::max)(size, align));
+			block* temp = static_cast<block*>(p);
+			temp->next_m = free_m[index];
+			free_m[index] = temp;
+		}
+		bool do_is_equal(const memory_resource& r) const noexcept { return this == &r; }
+	public:
+		explicit unsynchronized_pool_resource(memory_resource* upstream = get_default_resource()) : upstream_m(upstream), chunks_m(nullptr) {
+			for (size_t i = 0; i < pool_count; ++i) {
+				free_m[i] = nullptr;
+				blocks_per_chunk_m[i] = (iml::max<size_t>)(1, 1024 / block_size(i));
+			}
+		}
+		unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+		~unsynchronized_pool_resource() { release(); }
+
+		unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+		//  チャンクを全て上流へ返却する(プールから確保された領域は全て無効となる)
+		void release() noexcept {
+			for (chunk* ptr = chunks_m; ptr != nullptr;) {
+				chunk* temp = ptr; ptr = ptr->next_m;
+				upstream_m->deallocate(static_cast<void*>(temp), temp->size_m, alignof(chunk));
+			}
+			chunks_m = nullptr;
+			for (size_t i = 0; i < pool_count; ++i) free_m[i] = nullptr;
+		}
+
+		memory_resource* upstream_resource() const noexcept { return upstream_m; }
+	};
+
+
+	//  memory_resourceを通して確保するアロケータ(メモリ資源は型に現れないため実行時に切り替えられる)
+	template <class T>
+	class polymorphic_allocator {
+		template <class>
+		friend class polymorphic_allocator;
+
+		memory_resource*	resource_m;
+	public:
+		//  既定のメモリ資源を用いる
+		polymorphic_allocator() noexcept : resource_m(get_default_resource()) {}
+		polymorphic_allocator(memory_resource* r) noexcept : resource_m(r) {}
+		polymorphic_allocator(const polymorphic_allocator& a) noexcept : resource_m(a.resource_m) {}
+		template <class U>
+		polymorphic_allocator(const polymorphic_allocator<U>& a) noexcept : resource_m(a.resource_m) {}
+		~polymorphic_allocator() {}
+
+		using value_type = T;
+		using pointer = T * ;
+
+		template <class Other>
+		struct rebind {
+			using other = polymorphic_allocator<Other>;
+		};
+		template <class Other>
+		using rebind_t = polymorphic_allocator<Other>;
+
+		//  メモリ確保
+		[[nodiscard]] pointer allocate(size_t n) { return static_cast<pointer>(resource_m->allocate(n * sizeof(value_type), alignof(value_type))); }
+		//  メモリ解放
+		void deallocate(pointer p, size_t n) {
+			if (p == nullptr) return;
+			resource_m->deallocate(static_cast<void*>(p), n * sizeof(value_type), alignof(value_type));
+		}
+
+		//  コピーされたコンテナも同一のメモリ資源を用いる
+		polymorphic_allocator select_on_container_copy_construction() const { return *this; }
+
+		memory_resource* resource() const noexcept { return resource_m; }
+
+		polymorphic_allocator& operator=(const polymorphic_allocator& a) noexcept { resource_m = a.resource_m; return *this; }
+	};
+	template <class T, class U>
+	bool operator==(const polymorphic_allocator<T>& a1, const polymorphic_allocator<U>& a2) noexcept { return *a1.resource() == *a2.resource(); }
+	template <class T, class U>
+	bool operator!=(const polymorphic_allocator<T>& a1, const polymorphic_allocator<U>& a2) noexcept { return !(a1 == a2); }
+
+}
+
+
+#endif
\ No newline at end of file
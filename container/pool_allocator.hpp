@@ -0,0 +1,173 @@
+﻿#ifndef IMATHLIB_CONTAINER_POOL_ALLOCATOR_HPP
+#define IMATHLIB_CONTAINER_POOL_ALLOCATOR_HPP
+
+#include "IMathLib/container/allocator.hpp"
+#include <mutex>
+
+
+//  固定サイズのブロックを扱うプールアロケータ
+namespace iml {
+
+	namespace alloc {
+		//  空きブロック(空きである間はブロックの先頭に次の空きブロックを格納する)
+		struct pool_block {
+			pool_block*	next_m;
+		};
+
+		//  ブロックのサイズ毎の中央プール(スラブを所有してスレッド毎のキャッシュとブロックを受け渡しする)
+		template <size_t Size, size_t Align>
+		class central_pool {
+			//  スラブのヘッダ(直後にブロックが並ぶ)
+			struct alignas(Align) slab {
+				slab*	next_m;
+			};
+
+			std::mutex		mtx_m;
+			slab*			slabs_m;			//  確保したスラブ
+			pool_block*		free_m;				//  空きブロック
+			size_t			free_size_m;		//  空きブロック数
+
+			central_pool() : slabs_m(nullptr), free_m(nullptr), free_size_m(0) {}
+		public:
+			static constexpr size_t block_size = Size;
+
+			central_pool(const central_pool&) = delete;
+
+			central_pool& operator=(const central_pool&) = delete;
+
+			//  静的な寿命のコンテナやスレッドの終了時のキャッシュの返却から参照されるため破棄しない(スラブはプロセスの終了まで保持する)
+			static central_pool& instance() {
+				static central_pool* pool = new central_pool();
+				return *pool;
+			}
+
+			//  最大n個の空きブロックを連結リストとして取得(空きがなければn個分のスラブを確保する)
+			pool_block* acquire(size_t n, size_t& count) {
+				std::lock_guard<std::mutex> lock(mtx_m);
+				if (free_m == nullptr) {
+					slab* temp = static_cast<slab*>(::operator new(sizeof(slab) + Size * n));
+					temp->next_m = slabs_m;
+					slabs_m = temp;
+					//  スラブをブロックに分割して連結する
+					unsigned char* p = reinterpret_cast<unsigned char*>(temp + 1);
+					for (size_t i = 0; i < n; ++i) {
+						pool_block* block = reinterpret_cast<pool_block*>(p + Size * i);
+						block->next_m = (i + 1 < n) ? reinterpret_cast<pool_block*>(p + Size * (i + 1)) : free_m;
+					}
+					free_m = reinterpret_cast<pool_block*>(p);
+					free_size_m += n;
+				}
+				pool_block* first = free_m;
+				pool_block* last = free_m;
+				for (count = 1; (count < n) && (last->next_m != nullptr); ++count) last = last->next_m;
+				free_m = last->next_m;
+				last->next_m = nullptr;
+				free_size_m -= count;
+				return first;
+			}
+			//  [first, last]のn個のブロックを返却
+			void release(pool_block* first, pool_block* last, size_t n) {
+				std::lock_guard<std::mutex> lock(mtx_m);
+				last->next_m = free_m;
+				free_m = first;
+				free_size_m += n;
+			}
+		};
+
+		//  スレッド毎のブロックのキャッシュ(中央プールとはBatch個単位で受け渡しする)
+		template <size_t Size, size_t Align, size_t Batch>
+		class pool_cache {
+			pool_block*		free_m;				//  空きブロック
+			size_t			size_m;				//  空きブロック数
+
+			pool_cache() : free_m(nullptr), size_m(0) {}
+		public:
+			pool_cache(const pool_cache&) = delete;
+			//  スレッドの終了時に空きブロックを中央プールへ返却する
+			~pool_cache() {
+				if (free_m == nullptr) return;
+				pool_block* last = free_m;
+				while (last->next_m != nullptr) last = last->next_m;
+				central_pool<Size, Align>::instance().release(free_m, last, size_m);
+			}
+
+			pool_cache& operator=(const pool_cache&) = delete;
+
+			static pool_cache& instance() {
+				static thread_local pool_cache cache;
+				return cache;
+			}
+
+			void* pop() {
+				if (free_m == nullptr) free_m = central_pool<Size, Align>::instance().acquire(Batch, size_m);
+				pool_block* temp = free_m;
+				free_m = temp->next_m;
+				--size_m;
+				return temp;
+			}
+			void push(void* p) {
+				pool_block* temp = static_cast<pool_block*>(p);
+				temp->next_m = free_m;
+				free_m = temp;
+				//  キャッシュが過剰になったときはBatch個を中央プールへ返却する
+				if (++size_m >= 2 * Batch) {
+					pool_block* last = free_m;
+					for (size_t i = 1; i < Batch; ++i) last = last->next_m;
+					pool_block* first = free_m;
+					free_m = last->next_m;
+					size_m -= Batch;
+					central_pool<Size, Align>::instance().release(first, last, Batch);
+				}
+			}
+		};
+	}
+
+
+	//  要素1個単位の確保をプールから行うアロケータ(list_nodeやtree_mapのノードのため)
+	//  Batch:スレッド毎のキャッシュと中央プールで受け渡しするブロック数
+	template <class T, size_t Batch = 64>
+	class pool_allocator {
+		static constexpr size_t block_align = (alignof(T) > alignof(alloc::pool_block)) ? alignof(T) : alignof(alloc::pool_block);
+		static constexpr size_t block_size = (((sizeof(T) > sizeof(alloc::pool_block)) ? sizeof(T) : sizeof(alloc::pool_block)) + block_align - 1) / block_align * block_align;
+
+		static_assert(block_align <= alignof(max_align_t), "over-aligned types are not supported.");
+
+		using cache_type = alloc::pool_cache<block_size, block_align, Batch>;
+	public:
+		constexpr pool_allocator() noexcept {}
+		constexpr pool_allocator(const pool_allocator&) noexcept {}
+		template <class U>
+		constexpr pool_allocator(const pool_allocator<U, Batch>&) noexcept {}
+		~pool_allocator() {}
+
+		using value_type = T;
+		using pointer = T * ;
+
+		template <class Other>
+		struct rebind {
+			using other = pool_allocator<Other, Batch>;
+		};
+		template <class Other>
+		using rebind_t = pool_allocator<Other, Batch>;
+
+		//  メモリ確保(1要素のときのみプールを用いる)
+		[[nodiscard]] pointer allocate(size_t n) {
+			if (n == 1) return static_cast<pointer>(cache_type::instance().pop());
+			return static_cast<pointer>(::operator new(n * sizeof(value_type)));
+		}
+		//  メモリ解放
+		void deallocate(pointer p, size_t n) {
+			if (p == nullptr) return;
+			if (n == 1) cache_type::instance().push(static_cast<void*>(p));
+			else ::operator delete(static_cast<void*>(p));
+		}
+	};
+	template <class T, class U, size_t Batch>
+	bool operator==(const pool_allocator<T, Batch>&, const pool_allocator<U, Batch>&) { return true; }
+	template <class T, class U, size_t Batch>
+	bool operator!=(const pool_allocator<T, Batch>&, const pool_allocator<U, Batch>&) { return false; }
+
+}
+
+
+#endif
\ No newline at end of file
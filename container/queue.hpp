@@ -2,13 +2,14 @@
 #define _QUEUE_HPP
 
 #include "IMathLib/container/list.hpp"
+#include "IMathLib/container/ring_buffer.hpp"
 
 // キュー
 
 namespace iml {
 
 	// キュー
-	template <class T, class Container = list<T>>
+	template <class T, class Container = ring_buffer<T>>
 	class queue {
 	protected:
 		Container	cont;
@@ -22,6 +23,7 @@ namespace iml {
 		~queue() {}
 
 		void enqueue(const T& v) { cont.push_back(v); }
+		void enqueue(T&& v) { cont.push_back(move(v)); }
 		void dequeue() { cont.pop_front(); }
 
 		T& front() { return *cont.begin(); }
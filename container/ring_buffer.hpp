@@ -0,0 +1,250 @@
+﻿#ifndef IMATHLIB_CONTAINER_RING_BUFFER_HPP
+#define IMATHLIB_CONTAINER_RING_BUFFER_HPP
+
+#include "IMathLib/container/allocator.hpp"
+#include "IMathLib/container/memory_resource.hpp"
+
+
+//  2の冪の容量を持つ連続領域のリングバッファ
+namespace iml {
+
+	//  リングバッファのイテレータ(位置はマスクを取る前の値で保持する)
+	template <class T>
+	struct ring_buffer_iterator {
+		T*		p_m;				//  領域の先頭
+		size_t	mask_m;				//  容量 - 1
+		size_t	pos_m;				//  位置(実際の位置はpos_m & mask_m)
+
+		using iterator_category = random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		template <class Other>
+		struct rebind {
+			using other = ring_buffer_iterator<Other>;
+		};
+		template <class Other>
+		using rebind_t = ring_buffer_iterator<Other>;
+
+		constexpr ring_buffer_iterator() : p_m(nullptr), mask_m(0), pos_m(0) {}
+		constexpr ring_buffer_iterator(T* p, size_t mask, size_t pos) : p_m(p), mask_m(mask), pos_m(pos) {}
+		template <class U>
+		constexpr ring_buffer_iterator(const ring_buffer_iterator<U>& itr) : p_m(const_cast<T*>(itr.p_m)), mask_m(itr.mask_m), pos_m(itr.pos_m) {}
+
+		constexpr reference operator*() const { return p_m[pos_m & mask_m]; }
+		constexpr pointer operator->() const { return p_m + (pos_m & mask_m); }
+		constexpr ring_buffer_iterator& operator++() { ++pos_m; return *this; }
+		constexpr ring_buffer_iterator operator++(int) { ring_buffer_iterator temp = *this; ++*this; return temp; }
+		constexpr ring_buffer_iterator& operator--() { --pos_m; return *this; }
+		constexpr ring_buffer_iterator operator--(int) { ring_buffer_iterator temp = *this; --*this; return temp; }
+
+		constexpr ring_buffer_iterator operator+(difference_type n) const { return ring_buffer_iterator(p_m, mask_m, pos_m + n); }
+		constexpr ring_buffer_iterator operator-(difference_type n) const { return ring_buffer_iterator(p_m, mask_m, pos_m - n); }
+		constexpr difference_type operator-(const ring_buffer_iterator& itr) const { return static_cast<difference_type>(pos_m - itr.pos_m); }
+
+		ring_buffer_iterator& operator+=(difference_type n) { pos_m += n; return *this; }
+		ring_buffer_iterator& operator-=(difference_type n) { pos_m -= n; return *this; }
+
+		constexpr reference operator[](difference_type n) const { return p_m[(pos_m + n) & mask_m]; }
+
+		constexpr bool operator==(const ring_buffer_iterator& itr) const { return pos_m == itr.pos_m; }
+		constexpr bool operator!=(const ring_buffer_iterator& itr) const { return pos_m != itr.pos_m; }
+		constexpr bool operator<(const ring_buffer_iterator& itr) const { return pos_m < itr.pos_m; }
+		constexpr bool operator>(const ring_buffer_iterator& itr) const { return pos_m > itr.pos_m; }
+		constexpr bool operator<=(const ring_buffer_iterator& itr) const { return pos_m <= itr.pos_m; }
+		constexpr bool operator>=(const ring_buffer_iterator& itr) const { return pos_m >= itr.pos_m; }
+	};
+
+
+	//  リングバッファ(両端への追加と削除が償却O(1)で要素毎のメモリ確保を行わない)
+	template <class T, class Allocator = allocator<T>>
+	class ring_buffer {
+	public:
+		using value_type = T;
+		using reference = T & ;
+		using const_reference = const T &;
+		using iterator = ring_buffer_iterator<T>;
+		using const_iterator = ring_buffer_iterator<const T>;
+		using allocator_type = Allocator;
+		using size_type = typename allocator_traits<Allocator>::size_type;
+
+		static constexpr size_type min_capacity = 8;
+	private:
+		T*			p_m;				//  確保したメモリ領域
+		size_type	size_m;				//  確保したメモリのサイズ(0または2の冪)
+		size_type	head_m;				//  先頭の要素の位置
+		size_type	use_size_m;			//  要素数
+		Allocator	alloc_m;
+
+		size_type mask() const noexcept { return size_m - 1; }
+		//  size以上の最小の2の冪
+		static constexpr size_type ceil_pow2(size_type size) {
+			size_type result = min_capacity;
+			while (result < size) result <<= 1;
+			return result;
+		}
+		//  容量をsizeにして要素を先頭から詰めて移す
+		void reallocate(size_type size) {
+			if (max_size() < size) throw std::length_error("size exceeds max_size().");
+			auto temp = alloc_m.allocate(size);
+			//  要素は[head_m, size_m)と[0, tail)の2つの連続領域に分かれている
+			size_type n1 = (iml::min)(use_size_m, size_m - head_m);
+			allocator_traits<Allocator>::move_if_noexcept_construct(alloc_m, temp, temp + n1, p_m + head_m, p_m + head_m + n1);
+			allocator_traits<Allocator>::move_if_noexcept_construct(alloc_m, temp + n1, temp + use_size_m, p_m, p_m + (use_size_m - n1));
+			destroy_all();
+			alloc_m.deallocate(p_m, size_m);
+			p_m = temp;
+			size_m = size;
+			head_m = 0;
+		}
+		//  全ての要素にデストラクタを適用する
+		void destroy_all() {
+			size_type n1 = (iml::min)(use_size_m, size_m - head_m);
+			allocator_traits<Allocator>::destroy(alloc_m, p_m + head_m, p_m + head_m + n1);
+			allocator_traits<Allocator>::destroy(alloc_m, p_m, p_m + (use_size_m - n1));
+		}
+	public:
+		constexpr ring_buffer() : p_m(nullptr), size_m(0), head_m(0), use_size_m(0), alloc_m() {}
+		explicit ring_buffer(const Allocator& alloc) : p_m(nullptr), size_m(0), head_m(0), use_size_m(0)
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)) {}
+		template <class InputIterator>
+		ring_buffer(InputIterator first, InputIterator last) : p_m(nullptr), size_m(0), head_m(0), use_size_m(0), alloc_m() {
+			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
+
+			if constexpr (is_iterator_v<InputIterator, forward_iterator_tag>) reserve(distance(first, last));
+			for (; first != last; ++first) emplace_back(*first);
+		}
+		ring_buffer(const ring_buffer& r) : p_m(nullptr), size_m(0), head_m(0), use_size_m(0)
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(r.alloc_m)) { *this = r; }
+		ring_buffer(ring_buffer&& r) : p_m(r.p_m), size_m(r.size_m), head_m(r.head_m), use_size_m(r.use_size_m), alloc_m(r.alloc_m) {
+			r.p_m = nullptr;
+			r.size_m = r.head_m = r.use_size_m = 0;
+		}
+		~ring_buffer() {
+			clear();
+			alloc_m.deallocate(p_m, size_m);
+		}
+
+		iterator begin() noexcept { return iterator(p_m, mask(), head_m); }
+		const_iterator begin() const noexcept { return const_iterator(p_m, mask(), head_m); }
+		iterator end() noexcept { return iterator(p_m, mask(), head_m + use_size_m); }
+		const_iterator end() const noexcept { return const_iterator(p_m, mask(), head_m + use_size_m); }
+
+		//  要素の全消去(領域は保持する)
+		void clear() {
+			destroy_all();
+			head_m = use_size_m = 0;
+		}
+		bool empty() const noexcept { return use_size_m == 0; }
+		size_type size() const noexcept { return use_size_m; }
+		size_type capacity() const noexcept { return size_m; }
+		constexpr size_type max_size() const { return allocator_traits<Allocator>::max_size(alloc_m); }
+		//  size以上の2の冪の容量を確保する
+		void reserve(size_type size) {
+			if (size <= size_m) return;
+			reallocate(ceil_pow2(size));
+		}
+		void swap(ring_buffer& r) {
+			iml::swap(p_m, r.p_m);
+			iml::swap(size_m, r.size_m);
+			iml::swap(head_m, r.head_m);
+			iml::swap(use_size_m, r.use_size_m);
+			iml::swap(alloc_m, r.alloc_m);
+		}
+		// 内部イテレータ(2つの連続領域を順に走査する)
+		template <class F>
+		F for_each(F f) const {
+			size_type n1 = (iml::min)(use_size_m, size_m - head_m);
+			for (const T *p = p_m + head_m, *last = p_m + head_m + n1; p != last; ++p) f(*p);
+			for (const T *p = p_m, *last = p_m + (use_size_m - n1); p != last; ++p) f(*p);
+			return f;
+		}
+
+
+		// 前後への挿入
+		ring_buffer& push_front(const T& v) { emplace_front(v); return *this; }
+		ring_buffer& push_front(T&& v) { emplace_front(move(v)); return *this; }
+		ring_buffer& push_back(const T& v) { emplace_back(v); return *this; }
+		ring_buffer& push_back(T&& v) { emplace_back(move(v)); return *this; }
+		template <class... Types>
+		reference emplace_front(Types&&... args) {
+			//  引数が自身の要素であるときのために先に構築する
+			if (use_size_m == size_m) {
+				T temp(forward<Types>(args)...);
+				reallocate((size_m == 0) ? min_capacity : size_m * 2);
+				allocator_traits<Allocator>::construct(alloc_m, p_m + ((head_m - 1) & mask()), move(temp));
+			}
+			else allocator_traits<Allocator>::construct(alloc_m, p_m + ((head_m - 1) & mask()), forward<Types>(args)...);
+			head_m = (head_m - 1) & mask();
+			++use_size_m;
+			return p_m[head_m];
+		}
+		template <class... Types>
+		reference emplace_back(Types&&... args) {
+			if (use_size_m == size_m) {
+				T temp(forward<Types>(args)...);
+				reallocate((size_m == 0) ? min_capacity : size_m * 2);
+				allocator_traits<Allocator>::construct(alloc_m, p_m + ((head_m + use_size_m) & mask()), move(temp));
+			}
+			else allocator_traits<Allocator>::construct(alloc_m, p_m + ((head_m + use_size_m) & mask()), forward<Types>(args)...);
+			return p_m[(head_m + use_size_m++) & mask()];
+		}
+		ring_buffer& pop_front() {
+			if (use_size_m == 0) return *this;
+
+			allocator_traits<Allocator>::destroy(alloc_m, p_m + head_m);
+			head_m = (head_m + 1) & mask();
+			--use_size_m;
+			return *this;
+		}
+		ring_buffer& pop_back() {
+			if (use_size_m == 0) return *this;
+
+			--use_size_m;
+			allocator_traits<Allocator>::destroy(alloc_m, p_m + ((head_m + use_size_m) & mask()));
+			return *this;
+		}
+
+		//  代入
+		ring_buffer& operator=(const ring_buffer& r) {
+			if (this == addressof(r)) return *this;
+			clear();
+			reserve(r.use_size_m);
+			r.for_each([this](const T& v) { allocator_traits<Allocator>::construct(alloc_m, p_m + use_size_m++, v); });
+			return *this;
+		}
+		ring_buffer& operator=(ring_buffer&& r) {
+			if (this == addressof(r)) return *this;
+			clear();
+			alloc_m.deallocate(p_m, size_m);
+			p_m = r.p_m; size_m = r.size_m;
+			head_m = r.head_m; use_size_m = r.use_size_m;
+			alloc_m = r.alloc_m;
+			r.p_m = nullptr;
+			r.size_m = r.head_m = r.use_size_m = 0;
+			return *this;
+		}
+
+		T& operator[](size_type index) noexcept { return p_m[(head_m + index) & mask()]; }
+		const T& operator[](size_type index) const noexcept { return p_m[(head_m + index) & mask()]; }
+
+		// 前後へのアクセス
+		T& front() { return p_m[head_m]; }
+		const T& front() const { return p_m[head_m]; }
+		T& back() { return p_m[(head_m + use_size_m - 1) & mask()]; }
+		const T& back() const { return p_m[(head_m + use_size_m - 1) & mask()]; }
+	};
+
+
+	//  memory_resourceにより実行時にメモリ確保の方法を切り替えるコンテナ
+	namespace pmr {
+		template <class T>
+		using ring_buffer = iml::ring_buffer<T, polymorphic_allocator<T>>;
+	}
+
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,316 @@
+﻿#ifndef IMATHLIB_CONTAINER_SOA_ARRAY_HPP
+#define IMATHLIB_CONTAINER_SOA_ARRAY_HPP
+
+#include "IMathLib/container/allocator.hpp"
+#include "IMathLib/container/memory_resource.hpp"
+
+
+//  成分毎に連続した領域へ格納する数学型の動的配列(構造体の配列ではなく配列の構造体)
+namespace iml {
+
+	template <class, size_t>
+	class vector;
+	template <class>
+	class quaternion;
+	template <class, size_t, size_t>
+	class matrix;
+
+
+	//  成分へ分解する型の情報(成分の型と成分数)
+	//  成分はbegin()から順に走査した順序とする
+	template <class T>
+	struct soa_traits;
+	template <class T, size_t N>
+	struct soa_traits<vector<T, N>> {
+		using component_type = T;
+		static constexpr size_t size = N;
+	};
+	template <class T>
+	struct soa_traits<quaternion<T>> {
+		using component_type = T;
+		static constexpr size_t size = 4;
+	};
+	template <class T, size_t M, size_t N>
+	struct soa_traits<matrix<T, M, N>> {
+		using component_type = T;
+		static constexpr size_t size = M * N;
+	};
+
+
+	template <class T, class C>
+	class soa_reference;
+	template <class T>
+	struct is_soa_reference : false_type {};
+	template <class T, class C>
+	struct is_soa_reference<soa_reference<T, C>> : true_type {};
+
+	//  演算に用いる値(soa_referenceであれば要素の値)
+	template <class U>
+	inline const U& soa_value(const U& v) { return v; }
+	template <class T, class C>
+	inline T soa_value(const soa_reference<T, C>& r) { return r.get(); }
+
+
+	//  soa_arrayの要素の参照(各成分の領域へ分散している要素を値として読み書きする)
+	//  Cはconstであれば読み取り専用となる
+	//  数学型の演算子はテンプレートの実引数推論により暗黙の変換を経由しないため,演算子は要素の値へ展開して転送する
+	template <class T, class C>
+	class soa_reference {
+		template <class, class>
+		friend struct soa_iterator;
+
+		C*		p_m;				//  第0成分の位置
+		size_t	stride_m;			//  成分の領域の間隔
+	public:
+		static constexpr size_t size = soa_traits<T>::size;
+
+		constexpr soa_reference(C* p, size_t stride) : p_m(p), stride_m(stride) {}
+		constexpr soa_reference(const soa_reference&) = default;
+
+		//  要素の値
+		T get() const {
+			T temp;
+			auto itr = temp.begin();
+			for (size_t k = 0; k < size; ++k, ++itr) *itr = p_m[k * stride_m];
+			return temp;
+		}
+		operator T() const { return get(); }
+		//  第k成分
+		C& operator[](size_t k) const { return p_m[k * stride_m]; }
+
+		const soa_reference& operator=(const T& v) const {
+			auto itr = v.begin();
+			for (size_t k = 0; k < size; ++k, ++itr) p_m[k * stride_m] = *itr;
+			return *this;
+		}
+		const soa_reference& operator=(const soa_reference& r) const { return *this = r.get(); }
+		template <class U>
+		const soa_reference& operator+=(const U& v) const { T temp = get(); temp += soa_value(v); return *this = temp; }
+		template <class U>
+		const soa_reference& operator-=(const U& v) const { T temp = get(); temp -= soa_value(v); return *this = temp; }
+		template <class U>
+		const soa_reference& operator*=(const U& v) const { T temp = get(); temp *= soa_value(v); return *this = temp; }
+		template <class U>
+		const soa_reference& operator/=(const U& v) const { T temp = get(); temp /= soa_value(v); return *this = temp; }
+
+		//  単項演算
+		auto operator-() const { return -get(); }
+		T operator+() const { return get(); }
+
+		//  2項演算(soa_reference同士とそれ以外の値との演算をそれぞれ要素の値の演算へ転送する)
+#define IMATHLIB_SOA_REFERENCE_BINARY_OPERATOR(OP) \
+		template <class T2, class C2> \
+		friend auto operator OP(const soa_reference& lhs, const soa_reference<T2, C2>& rhs) -> decltype(declval<const T&>() OP declval<const T2&>()) { return lhs.get() OP rhs.get(); } \
+		template <class U, class = std::enable_if_t<!is_soa_reference<U>::value>> \
+		friend auto operator OP(const soa_reference& lhs, const U& rhs) -> decltype(declval<const T&>() OP rhs) { return lhs.get() OP rhs; } \
+		template <class U, class = std::enable_if_t<!is_soa_reference<U>::value>> \
+		friend auto operator OP(const U& lhs, const soa_reference& rhs) -> decltype(lhs OP declval<const T&>()) { return lhs OP rhs.get(); }
+
+		IMATHLIB_SOA_REFERENCE_BINARY_OPERATOR(+)
+		IMATHLIB_SOA_REFERENCE_BINARY_OPERATOR(-)
+		IMATHLIB_SOA_REFERENCE_BINARY_OPERATOR(*)
+		IMATHLIB_SOA_REFERENCE_BINARY_OPERATOR(/)
+#undef IMATHLIB_SOA_REFERENCE_BINARY_OPERATOR
+	};
+
+
+	//  soa_arrayのイテレータ(間接参照はsoa_referenceを返す)
+	template <class T, class C>
+	struct soa_iterator {
+		C*		p_m;				//  第0成分の位置
+		size_t	stride_m;			//  成分の領域の間隔
+
+		using iterator_category = random_access_iterator_tag;
+		using value_type = T;
+		using difference_type = ptrdiff_t;
+		using pointer = void;
+		using reference = soa_reference<T, C>;
+
+		template <class Other>
+		struct rebind {
+			using other = soa_iterator<Other, C>;
+		};
+		template <class Other>
+		using rebind_t = soa_iterator<Other, C>;
+
+		constexpr soa_iterator() : p_m(nullptr), stride_m(0) {}
+		constexpr soa_iterator(C* p, size_t stride) : p_m(p), stride_m(stride) {}
+		template <class D>
+		constexpr soa_iterator(const soa_iterator<T, D>& itr) : p_m(itr.p_m), stride_m(itr.stride_m) {}
+
+		reference operator*() const { return reference(p_m, stride_m); }
+		reference operator[](difference_type n) const { return reference(p_m + n, stride_m); }
+		soa_iterator& operator++() { ++p_m; return *this; }
+		soa_iterator operator++(int) { soa_iterator temp = *this; ++p_m; return temp; }
+		soa_iterator& operator--() { --p_m; return *this; }
+		soa_iterator operator--(int) { soa_iterator temp = *this; --p_m; return temp; }
+		soa_iterator& operator+=(difference_type n) { p_m += n; return *this; }
+		soa_iterator& operator-=(difference_type n) { p_m -= n; return *this; }
+		soa_iterator operator+(difference_type n) const { return soa_iterator(p_m + n, stride_m); }
+		soa_iterator operator-(difference_type n) const { return soa_iterator(p_m - n, stride_m); }
+		friend soa_iterator operator+(difference_type n, const soa_iterator& itr) { return itr + n; }
+		difference_type operator-(const soa_iterator& itr) const { return p_m - itr.p_m; }
+
+		bool operator==(const soa_iterator& itr) const { return p_m == itr.p_m; }
+		bool operator!=(const soa_iterator& itr) const { return p_m != itr.p_m; }
+		bool operator<(const soa_iterator& itr) const { return p_m < itr.p_m; }
+		bool operator>(const soa_iterator& itr) const { return p_m > itr.p_m; }
+		bool operator<=(const soa_iterator& itr) const { return p_m <= itr.p_m; }
+		bool operator>=(const soa_iterator& itr) const { return p_m >= itr.p_m; }
+	};
+
+
+	//  数学型(vector,quaternion,matrix)の各成分をそれぞれ連続した領域へ格納する動的配列
+	//  lane(k)により第k成分の連続した領域を直接走査できるため,全要素への一括の変換は成分毎のループとして自動ベクトル化される
+	//  全ての成分の領域は1つの確保にまとめ,第k成分の領域は先頭から容量のk倍の位置に置かれる
+	template <class T, class Allocator = allocator<typename soa_traits<T>::component_type>>
+	class soa_array {
+	public:
+		using value_type = T;
+		using component_type = typename soa_traits<T>::component_type;
+		using reference = soa_reference<T, component_type>;
+		using const_reference = soa_reference<T, const component_type>;
+		using iterator = soa_iterator<T, component_type>;
+		using const_iterator = soa_iterator<T, const component_type>;
+		using allocator_type = Allocator;
+		using size_type = typename allocator_traits<Allocator>::size_type;
+
+		static constexpr size_t lanes = soa_traits<T>::size;			//  成分数
+	private:
+		component_type*	p_m;				//  成分の領域
+		size_type		size_m;				//  容量
+		size_type		use_size_m;			//  要素数
+		Allocator		alloc_m;
+
+		size_type recommend(size_type size) const {
+			if (size > max_size()) throw std::length_error("size exceeds max_size().");
+			return (iml::max)(size, (iml::min)(max_size(), size_m * 2));
+		}
+		//  容量をsizeにして要素を移す
+		void reallocate(size_type size) {
+			component_type* temp = alloc_m.allocate(size * lanes);
+			for (size_t k = 0; k < lanes; ++k) {
+				component_type *src = p_m + k * size_m, *dst = temp + k * size;
+				allocator_traits<Allocator>::move_if_noexcept_construct(alloc_m, dst, dst + use_size_m, src, src + use_size_m);
+				allocator_traits<Allocator>::destroy(alloc_m, src, src + use_size_m);
+			}
+			if (p_m != nullptr) alloc_m.deallocate(p_m, size_m * lanes);
+			p_m = temp;
+			size_m = size;
+		}
+		//  [first, last)の各成分を構築する
+		void construct_range(size_type first, size_type last) {
+			for (size_t k = 0; k < lanes; ++k)
+				for (size_type i = first; i < last; ++i) allocator_traits<Allocator>::construct(alloc_m, p_m + k * size_m + i);
+		}
+		void destroy_range(size_type first, size_type last) {
+			for (size_t k = 0; k < lanes; ++k) allocator_traits<Allocator>::destroy(alloc_m, p_m + k * size_m + first, p_m + k * size_m + last);
+		}
+	public:
+		soa_array() : p_m(nullptr), size_m(0), use_size_m(0), alloc_m() {}
+		explicit soa_array(const Allocator& alloc) : p_m(nullptr), size_m(0), use_size_m(0), alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)) {}
+		explicit soa_array(size_type size, const Allocator& alloc = Allocator()) : soa_array(alloc) { resize(size); }
+		//  構造体の配列からの変換
+		template <class InputIterator>
+		soa_array(InputIterator first, InputIterator last) : soa_array() {
+			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
+
+			for (; first != last; ++first) push_back(*first);
+		}
+		soa_array(const soa_array& a) : soa_array(a.alloc_m) { *this = a; }
+		soa_array(soa_array&& a) : p_m(a.p_m), size_m(a.size_m), use_size_m(a.use_size_m), alloc_m(a.alloc_m) {
+			a.p_m = nullptr;
+			a.size_m = a.use_size_m = 0;
+		}
+		~soa_array() {
+			clear();
+			if (p_m != nullptr) alloc_m.deallocate(p_m, size_m * lanes);
+		}
+
+		iterator begin() noexcept { return iterator(p_m, size_m); }
+		const_iterator begin() const noexcept { return const_iterator(p_m, size_m); }
+		iterator end() noexcept { return iterator(p_m + use_size_m, size_m); }
+		const_iterator end() const noexcept { return const_iterator(p_m + use_size_m, size_m); }
+
+		void clear() {
+			if (use_size_m == 0) return;
+			destroy_range(0, use_size_m);
+			use_size_m = 0;
+		}
+		bool empty() const noexcept { return use_size_m == 0; }
+		size_type size() const noexcept { return use_size_m; }
+		size_type capacity() const noexcept { return size_m; }
+		size_type max_size() const noexcept { return allocator_traits<Allocator>::max_size(alloc_m) / lanes; }
+		allocator_type get_allocator() const { return alloc_m; }
+		void reserve(size_type size) {
+			if (size <= size_m) return;
+			if (size > max_size()) throw std::length_error("size exceeds max_size().");
+			reallocate(size);
+		}
+		void resize(size_type size) {
+			if (size < use_size_m) destroy_range(size, use_size_m);
+			else if (size > use_size_m) {
+				if (size > size_m) reallocate(recommend(size));
+				construct_range(use_size_m, size);
+			}
+			use_size_m = size;
+		}
+		void swap(soa_array& a) {
+			iml::swap(p_m, a.p_m);
+			iml::swap(size_m, a.size_m);
+			iml::swap(use_size_m, a.use_size_m);
+			iml::swap(alloc_m, a.alloc_m);
+		}
+
+		//  第k成分の領域([lane(k), lane(k) + size()))
+		component_type* lane(size_t k) noexcept { return p_m + k * size_m; }
+		const component_type* lane(size_t k) const noexcept { return p_m + k * size_m; }
+
+		void push_back(const T& v) {
+			if (use_size_m == size_m) reallocate(recommend(use_size_m + 1));
+			auto itr = v.begin();
+			for (size_t k = 0; k < lanes; ++k, ++itr) allocator_traits<Allocator>::construct(alloc_m, p_m + k * size_m + use_size_m, *itr);
+			++use_size_m;
+		}
+		void pop_back() {
+			destroy_range(use_size_m - 1, use_size_m);
+			--use_size_m;
+		}
+
+		//  添え字アクセス(成分を集めた値として読み書きする)
+		reference operator[](size_type index) noexcept { return reference(p_m + index, size_m); }
+		const_reference operator[](size_type index) const noexcept { return const_reference(p_m + index, size_m); }
+		T get(size_type index) const { return (*this)[index].get(); }
+		void set(size_type index, const T& v) { (*this)[index] = v; }
+
+		//  代入
+		soa_array& operator=(const soa_array& a) {
+			if (this == addressof(a)) return *this;
+			clear();
+			reserve(a.use_size_m);
+			for (size_t k = 0; k < lanes; ++k) allocator_traits<Allocator>::copy_construct(alloc_m, lane(k), lane(k) + a.use_size_m, a.lane(k), a.lane(k) + a.use_size_m);
+			use_size_m = a.use_size_m;
+			return *this;
+		}
+		soa_array& operator=(soa_array&& a) {
+			if (this == addressof(a)) return *this;
+			clear();
+			if (p_m != nullptr) alloc_m.deallocate(p_m, size_m * lanes);
+			p_m = nullptr;
+			size_m = 0;
+			swap(a);
+			return *this;
+		}
+	};
+
+
+	//  memory_resourceにより実行時にメモリ確保の方法を切り替えるコンテナ
+	namespace pmr {
+		template <class T>
+		using soa_array = iml::soa_array<T, polymorphic_allocator<typename soa_traits<T>::component_type>>;
+	}
+
+}
+
+
+#endif
\ No newline at end of file
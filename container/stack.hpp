@@ -2,13 +2,14 @@
 #define IMATHLIB_CONTAINER_STACK_HPP
 
 #include "IMathLib/container/list.hpp"
+#include "IMathLib/container/ring_buffer.hpp"
 
 // スタック
 
 namespace iml {
 
 	// スタック
-	template <class T, class Container = list<T>>
+	template <class T, class Container = ring_buffer<T>>
 	class stack {
 	protected:
 		Container	cont;
@@ -22,6 +23,7 @@ namespace iml {
 		~stack() {}
 
 		void push(const T& v) { cont.push_back(v); }
+		void push(T&& v) { cont.push_back(move(v)); }
 		void pop() { cont.pop_back(); }
 
 		void dep() { push(peek()); }
@@ -0,0 +1,210 @@
+﻿#ifndef IMATHLIB_CONTAINER_TASK_SCHEDULER_HPP
+#define IMATHLIB_CONTAINER_TASK_SCHEDULER_HPP
+
+#include "IMathLib/container/work_stealing_deque.hpp"
+#include "IMathLib/container/concurrent_queue.hpp"
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+
+//  ワークスティーリングによるタスクスケジューラ
+namespace iml {
+
+	//  タスクの完了を待つための組
+	//  タスクが例外を送出したときは最初の例外を保持してwaitで再送出する
+	class task_group {
+		friend class task_scheduler;
+
+		std::atomic<size_t>		count_m;			//  完了していないタスクの数
+		std::atomic<bool>		failed_m;			//  例外を保持しているか
+		std::exception_ptr		exception_m;		//  最初に送出された例外
+
+		//  最初の例外のみ保持する(タスクの完了を示すcount_mの減少より前に書き込む)
+		void set_exception(std::exception_ptr e) noexcept {
+			if (!failed_m.exchange(true, std::memory_order_relaxed)) exception_m = e;
+		}
+	public:
+		task_group() : count_m(0), failed_m(false), exception_m() {}
+		task_group(const task_group&) = delete;
+		~task_group() {}
+
+		task_group& operator=(const task_group&) = delete;
+
+		bool done() const noexcept { return count_m.load(std::memory_order_acquire) == 0; }
+	};
+
+
+	//  ワーカースレッド毎にワークスティーリング両端キューを持つタスクスケジューラ
+	//  ワーカーが投入したタスクは自身のキューへ積み,それ以外のスレッドが投入したタスクは共有のキューを経由する
+	//  タスクはnew/deleteで確保する(静的な寿命のスケジューラの破棄時にスレッド毎のキャッシュを経由しないようにするため)
+	//  task_groupに属さないタスクが例外を送出したときは受け取る先がないためstd::terminateとなる
+	class task_scheduler {
+		struct task {
+			function<void()>	f_m;
+			task_group*			group_m;
+
+			task(function<void()>&& f, task_group* group) : f_m(move(f)), group_m(group) {}
+		};
+
+		struct alignas(cache_line_size) worker {
+			work_stealing_deque<task*>	deque_m;
+			std::thread					thread_m;
+		};
+
+		worker*					workers_m;
+		size_t					size_m;				//  ワーカー数
+		mpmc_queue<task*>		injection_m;		//  ワーカー以外から投入されたタスク
+
+		std::atomic<size_t>		pending_m;			//  取り出されていないタスクの数
+		std::atomic<size_t>		sleeping_m;			//  待機中のワーカー数
+		std::atomic<bool>		stop_m;
+		std::mutex				mtx_m;
+		std::condition_variable	cv_m;
+
+		//  現在のスレッドが属するスケジューラとワーカーの番号
+		static task_scheduler*& current_scheduler() noexcept {
+			static thread_local task_scheduler* s = nullptr;
+			return s;
+		}
+		static size_t& current_index() noexcept {
+			static thread_local size_t index = 0;
+			return index;
+		}
+		worker* current_worker() noexcept { return (current_scheduler() == this) ? workers_m + current_index() : nullptr; }
+
+		//  実行するタスクを探す(自身のキュー,共有のキュー,他のワーカーのキューの順)
+		task* find_task(worker* w) {
+			task* t = nullptr;
+			if ((w != nullptr) && w->deque_m.pop(t)) return t;
+			if (injection_m.try_dequeue(t)) return t;
+			size_t first = (w != nullptr) ? static_cast<size_t>(w - workers_m) + 1 : 0;
+			for (size_t i = 0; i < size_m; ++i) {
+				worker& victim = workers_m[(first + i) % size_m];
+				if ((&victim != w) && victim.deque_m.steal(t)) return t;
+			}
+			return nullptr;
+		}
+		//  タスクを実行して破棄する(例外を送出してもタスクの破棄とgroupの完了の通知は必ず行う)
+		void execute(task* t) {
+			pending_m.fetch_sub(1, std::memory_order_relaxed);
+			task_group* group = t->group_m;
+			try { t->f_m(); }
+			catch (...) {
+				if (group == nullptr) std::terminate();
+				group->set_exception(std::current_exception());
+			}
+			delete t;
+			if (group != nullptr) group->count_m.fetch_sub(1, std::memory_order_release);
+		}
+		void worker_main(size_t index) {
+			current_scheduler() = this;
+			current_index() = index;
+			worker* w = workers_m + index;
+			for (size_t count = 0; !stop_m.load(std::memory_order_acquire);) {
+				if (task* t = find_task(w)) {
+					execute(t);
+					count = 0;
+					continue;
+				}
+				if (++count < 64) { std::this_thread::yield(); continue; }
+				//  タスクがなければ投入されるまで眠る
+				std::unique_lock<std::mutex> lock(mtx_m);
+				sleeping_m.fetch_add(1);
+				cv_m.wait(lock, [this] { return (pending_m.load() > 0) || stop_m.load(); });
+				sleeping_m.fetch_sub(1);
+				count = 0;
+			}
+			current_scheduler() = nullptr;
+		}
+		void wake() {
+			if (sleeping_m.load() == 0) return;
+			{ std::lock_guard<std::mutex> lock(mtx_m); }
+			cv_m.notify_one();
+		}
+	public:
+		//  size:ワーカースレッドの数(0のときはハードウェアのスレッド数)
+		explicit task_scheduler(size_t size = 0, size_t injection_size = 1024)
+			: workers_m(nullptr), size_m((size != 0) ? size : (iml::max<size_t>)(1, std::thread::hardware_concurrency()))
+			, injection_m(injection_size), pending_m(0), sleeping_m(0), stop_m(false) {
+			workers_m = new worker[size_m];
+			for (size_t i = 0; i < size_m; ++i) workers_m[i].thread_m = std::thread([this, i] { worker_main(i); });
+		}
+		task_scheduler(const task_scheduler&) = delete;
+		//  残っているタスクを全て実行してから終了する
+		~task_scheduler() {
+			while (pending_m.load() > 0)
+				if (task* t = find_task(nullptr)) execute(t);
+				else std::this_thread::yield();
+			{
+				std::lock_guard<std::mutex> lock(mtx_m);
+				stop_m.store(true);
+			}
+			cv_m.notify_all();
+			for (size_t i = 0; i < size_m; ++i) workers_m[i].thread_m.join();
+			//  停止の直前に実行中であったタスクが投入したタスクはワーカーが取り出さずに残るため,このスレッドで実行する
+			while (task* t = find_task(nullptr)) execute(t);
+			delete[] workers_m;
+		}
+
+		task_scheduler& operator=(const task_scheduler&) = delete;
+
+		//  既定で用いるスケジューラ
+		static task_scheduler& global() {
+			static task_scheduler s;
+			return s;
+		}
+
+		//  タスクの投入(groupを指定したときはwaitで完了を待機できる)
+		template <class F>
+		void submit(F&& f, task_group* group = nullptr) {
+			if (group != nullptr) group->count_m.fetch_add(1, std::memory_order_relaxed);
+			task* t = new task(function<void()>(forward<F>(f)), group);
+			pending_m.fetch_add(1);
+			if (worker* w = current_worker()) w->deque_m.push(t);
+			else injection_m.enqueue(t);
+			wake();
+		}
+		template <class F>
+		void submit(F&& f, task_group& group) { submit(forward<F>(f), addressof(group)); }
+
+		//  groupのタスクが全て完了するまで待機する(待機中のスレッドもタスクを実行する)
+		//  groupのタスクが例外を送出していたときは全てのタスクの完了後に最初の例外を再送出する
+		void wait(task_group& group) {
+			worker* w = current_worker();
+			for (size_t count = 0; !group.done();) {
+				if (task* t = find_task(w)) {
+					execute(t);
+					count = 0;
+				}
+				else alloc::backoff(count);
+			}
+			if (group.failed_m.load(std::memory_order_relaxed)) {
+				std::exception_ptr e = move(group.exception_m);
+				group.exception_m = nullptr;
+				group.failed_m.store(false, std::memory_order_relaxed);
+				std::rethrow_exception(e);
+			}
+		}
+
+		//  [first, last)をgrain個ずつに分割してf(i)を並列に実行する
+		template <class F>
+		void parallel_for(size_t first, size_t last, size_t grain, F f) {
+			if (first >= last) return;
+			if (grain == 0) grain = 1;
+			task_group group;
+			for (size_t i = first; i < last; i += grain) {
+				size_t end = (last - i > grain) ? i + grain : last;
+				submit([&f, i, end] { for (size_t j = i; j < end; ++j) f(j); }, group);
+			}
+			wait(group);
+		}
+
+		size_t size() const noexcept { return size_m; }
+	};
+
+}
+
+
+#endif
\ No newline at end of file
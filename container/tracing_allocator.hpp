@@ -0,0 +1,166 @@
+﻿#ifndef IMATHLIB_CONTAINER_TRACING_ALLOCATOR_HPP
+#define IMATHLIB_CONTAINER_TRACING_ALLOCATOR_HPP
+
+#include "IMathLib/container/allocator.hpp"
+#include <atomic>
+
+
+//  メモリ確保の統計を記録するアロケータのアダプタ
+namespace iml {
+
+	//  メモリ確保の統計(同一のコンテナ群に対するアロケータで共有する)
+	class allocation_statistics {
+	public:
+		//  サイズのヒストグラムの階級数(k番目の階級は(2^(k-1), 2^k]バイトの確保の回数)
+		static constexpr size_t histogram_size = 32;
+
+		//  ある時点での統計の写し
+		struct snapshot {
+			const char*		tag;								//  呼び出し元などを識別する名前
+			size_t			live_bytes;							//  解放されていないバイト数
+			size_t			peak_bytes;							//  live_bytesの最大値
+			size_t			allocation_count;					//  確保の回数
+			size_t			deallocation_count;					//  解放の回数
+			size_t			histogram[histogram_size];			//  確保したサイズのヒストグラム
+
+			//  ストリームへの出力(loggerへもそのまま出力できる)
+			template <class Stream>
+			friend Stream& operator<<(Stream& os, const snapshot& s) {
+				os << "[" << ((s.tag != nullptr) ? s.tag : "untagged") << "] live:" << s.live_bytes << " peak:" << s.peak_bytes
+					<< " alloc:" << s.allocation_count << " dealloc:" << s.deallocation_count << " histogram:";
+				for (size_t i = 0; i < histogram_size; ++i)
+					if (s.histogram[i] != 0) os << " <=" << (size_t(1) << i) << ":" << s.histogram[i];
+				return os;
+			}
+		};
+	private:
+		const char*				tag_m;
+		std::atomic<size_t>		live_bytes_m;
+		std::atomic<size_t>		peak_bytes_m;
+		std::atomic<size_t>		allocation_count_m;
+		std::atomic<size_t>		deallocation_count_m;
+		std::atomic<size_t>		histogram_m[histogram_size];
+
+		//  sizeバイトの属する階級
+		static constexpr size_t histogram_index(size_t size) {
+			size_t result = 0;
+			for (size_t n = 1; (n < size) && (result + 1 < histogram_size); n <<= 1) ++result;
+			return result;
+		}
+	public:
+		explicit allocation_statistics(const char* tag = nullptr) : tag_m(tag), live_bytes_m(0), peak_bytes_m(0), allocation_count_m(0), deallocation_count_m(0), histogram_m{} {}
+		allocation_statistics(const allocation_statistics&) = delete;
+		~allocation_statistics() {}
+
+		allocation_statistics& operator=(const allocation_statistics&) = delete;
+
+		//  既定で用いる統計
+		static allocation_statistics& global() {
+			static allocation_statistics stats("global");
+			return stats;
+		}
+
+		//  確保と解放の記録
+		void on_allocate(size_t size) noexcept {
+			size_t live = live_bytes_m.fetch_add(size, std::memory_order_relaxed) + size;
+			size_t peak = peak_bytes_m.load(std::memory_order_relaxed);
+			while ((peak < live) && !peak_bytes_m.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+			allocation_count_m.fetch_add(1, std::memory_order_relaxed);
+			histogram_m[histogram_index(size)].fetch_add(1, std::memory_order_relaxed);
+		}
+		void on_deallocate(size_t size) noexcept {
+			live_bytes_m.fetch_sub(size, std::memory_order_relaxed);
+			deallocation_count_m.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		//  現在の統計の取得
+		snapshot get() const noexcept {
+			snapshot result;
+			result.tag = tag_m;
+			result.live_bytes = live_bytes_m.load(std::memory_order_relaxed);
+			result.peak_bytes = peak_bytes_m.load(std::memory_order_relaxed);
+			result.allocation_count = allocation_count_m.load(std::memory_order_relaxed);
+			result.deallocation_count = deallocation_count_m.load(std::memory_order_relaxed);
+			for (size_t i = 0; i < histogram_size; ++i) result.histogram[i] = histogram_m[i].load(std::memory_order_relaxed);
+			return result;
+		}
+		//  live_bytes以外の統計を0にする(peak_bytesはlive_bytesとなる)
+		void reset() noexcept {
+			peak_bytes_m.store(live_bytes_m.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			allocation_count_m.store(0, std::memory_order_relaxed);
+			deallocation_count_m.store(0, std::memory_order_relaxed);
+			for (size_t i = 0; i < histogram_size; ++i) histogram_m[i].store(0, std::memory_order_relaxed);
+		}
+
+		const char* tag() const noexcept { return tag_m; }
+	};
+
+
+	//  Allocatorによる確保と解放をallocation_statisticsへ記録するアダプタ
+	template <class Allocator>
+	class tracing_allocator {
+		template <class>
+		friend class tracing_allocator;
+
+		Allocator					alloc_m;
+		allocation_statistics*		stats_m;
+	public:
+		using value_type = typename allocator_traits<Allocator>::value_type;
+		using pointer = typename allocator_traits<Allocator>::pointer;
+		using inner_allocator_type = Allocator;
+
+		static constexpr size_t alignment = allocator_traits<Allocator>::alignment;
+
+		template <class Other>
+		struct rebind {
+			using other = tracing_allocator<typename allocator_traits<Allocator>::template rebind_t<Other>>;
+		};
+		template <class Other>
+		using rebind_t = tracing_allocator<typename allocator_traits<Allocator>::template rebind_t<Other>>;
+
+		//  既定ではallocation_statistics::global()へ記録する
+		tracing_allocator() : alloc_m(), stats_m(addressof(allocation_statistics::global())) {}
+		explicit tracing_allocator(allocation_statistics& stats, const Allocator& alloc = Allocator()) : alloc_m(alloc), stats_m(addressof(stats)) {}
+		tracing_allocator(const tracing_allocator& a) : alloc_m(a.alloc_m), stats_m(a.stats_m) {}
+		template <class UAllocator>
+		tracing_allocator(const tracing_allocator<UAllocator>& a) : alloc_m(a.alloc_m), stats_m(a.stats_m) {}
+		~tracing_allocator() {}
+
+		//  メモリ確保
+		[[nodiscard]] pointer allocate(size_t n) {
+			pointer result = allocator_traits<Allocator>::allocate(alloc_m, n);
+			stats_m->on_allocate(n * sizeof(value_type));
+			return result;
+		}
+		//  メモリ解放
+		void deallocate(pointer p, size_t n) {
+			if (p == nullptr) return;
+			stats_m->on_deallocate(n * sizeof(value_type));
+			allocator_traits<Allocator>::deallocate(alloc_m, p, n);
+		}
+
+		//  コピーされたコンテナも同一の統計へ記録する
+		tracing_allocator select_on_container_copy_construction() const {
+			return tracing_allocator(*stats_m, allocator_traits<Allocator>::select_on_container_copy_construction(alloc_m));
+		}
+
+		allocation_statistics& statistics() const noexcept { return *stats_m; }
+		const Allocator& inner_allocator() const noexcept { return alloc_m; }
+
+		tracing_allocator& operator=(const tracing_allocator& a) {
+			alloc_m = a.alloc_m;
+			stats_m = a.stats_m;
+			return *this;
+		}
+	};
+	template <class TAllocator, class UAllocator>
+	bool operator==(const tracing_allocator<TAllocator>& a1, const tracing_allocator<UAllocator>& a2) {
+		return (a1.inner_allocator() == a2.inner_allocator()) && (addressof(a1.statistics()) == addressof(a2.statistics()));
+	}
+	template <class TAllocator, class UAllocator>
+	bool operator!=(const tracing_allocator<TAllocator>& a1, const tracing_allocator<UAllocator>& a2) { return !(a1 == a2); }
+
+}
+
+
+#endif
\ No newline at end of file
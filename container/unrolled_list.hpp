@@ -0,0 +1,445 @@
+﻿#ifndef IMATHLIB_CONTAINER_UNROLLED_LIST_HPP
+#define IMATHLIB_CONTAINER_UNROLLED_LIST_HPP
+
+#include "IMathLib/container/allocator.hpp"
+#include "IMathLib/container/memory_resource.hpp"
+
+
+//  1ノードに複数の要素を格納する双方向連結リスト(アンロールドリスト)
+namespace iml {
+
+	//  1ノードあたりの既定の要素数(要素の領域が256バイト程度となるようにする)
+	template <class T>
+	inline constexpr size_t unrolled_list_default_node_size = (sizeof(T) * 4 >= 256) ? 4 : 256 / sizeof(T);
+
+
+	//  アンロールドリストのノード(要素は[begin_m, end_m)の位置に連続して格納される)
+	template <class T, size_t N>
+	struct unrolled_list_node {
+		unrolled_list_node*		next_m;			//  次のノード
+		unrolled_list_node*		prev_m;			//  前のノード
+		size_t					begin_m;		//  使用中の範囲の先頭
+		size_t					end_m;			//  使用中の範囲の終端
+		alignas(T) unsigned char	data_m[sizeof(T) * N];
+
+		constexpr unrolled_list_node(unrolled_list_node* prev, unrolled_list_node* next, size_t pos) : next_m(next), prev_m(prev), begin_m(pos), end_m(pos) {}
+
+		T* data() noexcept { return reinterpret_cast<T*>(data_m); }
+		const T* data() const noexcept { return reinterpret_cast<const T*>(data_m); }
+		size_t size() const noexcept { return end_m - begin_m; }
+	};
+
+
+	//  アンロールドリストのイテレータ
+	template <class T, size_t N>
+	struct unrolled_list_iterator {
+		using node_type = unrolled_list_node<remove_const_t<T>, N>;
+
+		node_type*	node_m;				//  要素を格納しているノード
+		T*			current_m;			//  要素の位置(終端のときは最後のノードの使用中の範囲の終端)
+
+		using iterator_category = bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = ptrdiff_t;
+		using pointer = T*;
+		using reference = T&;
+
+		template<class Other>
+		struct rebind {
+			using other = unrolled_list_iterator<Other, N>;
+		};
+		template <class Other>
+		using rebind_t = unrolled_list_iterator<Other, N>;
+
+		constexpr unrolled_list_iterator() : node_m(nullptr), current_m(nullptr) {}
+		constexpr unrolled_list_iterator(node_type* node, T* current) : node_m(node), current_m(current) {}
+		template <class U>
+		constexpr unrolled_list_iterator(const unrolled_list_iterator<U, N>& itr) : node_m(itr.node_m), current_m(const_cast<T*>(itr.current_m)) {}
+
+		//  ノード内での位置
+		size_t index() const noexcept { return current_m - node_m->data(); }
+
+		reference operator*() const { return *current_m; }
+		pointer operator->() const { return current_m; }
+		unrolled_list_iterator& operator++() {
+			//  ノードの終端に達したときは次のノードの先頭へ進む(最後のノードならば終端となる)
+			if ((++current_m == node_m->data() + node_m->end_m) && (node_m->next_m != nullptr)) {
+				node_m = node_m->next_m;
+				current_m = node_m->data() + node_m->begin_m;
+			}
+			return *this;
+		}
+		unrolled_list_iterator operator++(int) { unrolled_list_iterator temp = *this; ++*this; return temp; }
+		unrolled_list_iterator& operator--() {
+			if (current_m == node_m->data() + node_m->begin_m) {
+				node_m = node_m->prev_m;
+				current_m = node_m->data() + node_m->end_m;
+			}
+			--current_m;
+			return *this;
+		}
+		unrolled_list_iterator operator--(int) { unrolled_list_iterator temp = *this; --*this; return temp; }
+
+		reference operator[](difference_type n) const { return *next(*this, n); }
+
+		bool operator==(const unrolled_list_iterator& itr) const { return current_m == itr.current_m; }
+		bool operator!=(const unrolled_list_iterator& itr) const { return !(*this == itr); }
+	};
+
+
+	//  アンロールドリスト(N個の要素を連続して格納するノードの双方向連結リスト)
+	//  要素の挿入と削除で無効となるイテレータは操作したノードの要素を指すもののみである
+	template <class T, size_t N = unrolled_list_default_node_size<T>, class Allocator = allocator<unrolled_list_node<T, N>>>
+	class unrolled_list {
+		static_assert(N >= 2, "the node must be able to hold at least 2 elements.");
+	public:
+		using value_type = T;
+		using reference = T & ;
+		using const_reference = const T &;
+		using iterator = unrolled_list_iterator<T, N>;
+		using const_iterator = unrolled_list_iterator<const T, N>;
+		using allocator_type = Allocator;
+		using size_type = typename allocator_traits<Allocator>::size_type;
+		using node_type = unrolled_list_node<T, N>;
+
+		static constexpr size_t node_size = N;
+	private:
+		Allocator		alloc_m;			//  アロケータ
+		node_type*		first_m;			//  一番最初のノード
+		node_type*		last_m;				//  一番最後のノード
+		size_type		size_m;				//  要素数
+
+		//  prevとnextの間に要素をposの位置から格納するノードを作成する
+		node_type* create_node(node_type* prev, node_type* next, size_t pos) {
+			node_type* temp = alloc_m.allocate(1);
+			allocator_traits<Allocator>::construct(alloc_m, temp, prev, next, pos);
+			if (prev == nullptr) first_m = temp;
+			else prev->next_m = temp;
+			if (next == nullptr) last_m = temp;
+			else next->prev_m = temp;
+			return temp;
+		}
+		//  要素が空となったノードを連結から外して解放する
+		void remove_node(node_type* node) {
+			if (node->prev_m == nullptr) first_m = node->next_m;
+			else node->prev_m->next_m = node->next_m;
+			if (node->next_m == nullptr) last_m = node->prev_m;
+			else node->next_m->prev_m = node->prev_m;
+			allocator_traits<Allocator>::destroy(alloc_m, node);
+			alloc_m.deallocate(node, 1);
+		}
+		//  nodeのindexの位置(begin_m <= index <= end_m)に要素を挿入する
+		iterator insert_node(node_type* node, size_t index, T&& v) {
+			//  ノードが満杯のときは後半を新しいノードへ移して分割する
+			if (node->size() == N) {
+				size_t mid = node->begin_m + N / 2;
+				node_type* temp = create_node(node, node->next_m, 0);
+				allocator_traits<Allocator>::move_construct(alloc_m, temp->data(), temp->data() + (node->end_m - mid), node->data() + mid, node->data() + node->end_m);
+				allocator_traits<Allocator>::destroy(alloc_m, node->data() + mid, node->data() + node->end_m);
+				temp->end_m = node->end_m - mid;
+				node->end_m = mid;
+				if (index > mid) {
+					index -= mid;
+					node = temp;
+				}
+			}
+			T* p = node->data();
+			//  後ろに空きがあれば[index, end_m)を後ろへずらす
+			if (node->end_m < N) {
+				if (index == node->end_m) allocator_traits<Allocator>::construct(alloc_m, p + index, move(v));
+				else {
+					allocator_traits<Allocator>::construct(alloc_m, p + node->end_m, move(p[node->end_m - 1]));
+					move_reverse_order(p + index + 1, p + index, p + node->end_m - 1);
+					p[index] = move(v);
+				}
+				++node->end_m;
+			}
+			//  そうでなければ[begin_m, index)を前へずらす
+			else {
+				--index;
+				if (index + 1 == node->begin_m) allocator_traits<Allocator>::construct(alloc_m, p + index, move(v));
+				else {
+					allocator_traits<Allocator>::construct(alloc_m, p + node->begin_m - 1, move(p[node->begin_m]));
+					move_order(p + node->begin_m, p + node->begin_m + 1, p + index + 1);
+					p[index] = move(v);
+				}
+				--node->begin_m;
+			}
+			++size_m;
+			return iterator(node, p + index);
+		}
+	public:
+		constexpr unrolled_list() : alloc_m(), first_m(nullptr), last_m(nullptr), size_m(0) {}
+		explicit unrolled_list(const Allocator& alloc) : alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc))
+			, first_m(nullptr), last_m(nullptr), size_m(0) {}
+		template <class InputIterator>
+		unrolled_list(InputIterator first, InputIterator last) : alloc_m(), first_m(nullptr), last_m(nullptr), size_m(0) {
+			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
+
+			for (; first != last; ++first) push_back(*first);
+		}
+		unrolled_list(const unrolled_list& l) : alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(l.alloc_m))
+			, first_m(nullptr), last_m(nullptr), size_m(0) { *this = l; }
+		unrolled_list(unrolled_list&& l) : alloc_m(l.alloc_m), first_m(l.first_m), last_m(l.last_m), size_m(l.size_m) {
+			l.first_m = l.last_m = nullptr;
+			l.size_m = 0;
+		}
+		~unrolled_list() { clear(); }
+
+		iterator begin() noexcept { return (first_m == nullptr) ? iterator() : iterator(first_m, first_m->data() + first_m->begin_m); }
+		const_iterator begin() const noexcept { return (first_m == nullptr) ? const_iterator() : const_iterator(first_m, first_m->data() + first_m->begin_m); }
+		iterator end() noexcept { return (last_m == nullptr) ? iterator() : iterator(last_m, last_m->data() + last_m->end_m); }
+		const_iterator end() const noexcept { return (last_m == nullptr) ? const_iterator() : const_iterator(last_m, last_m->data() + last_m->end_m); }
+
+		void clear() {
+			for (node_type* ptr = first_m; ptr != nullptr;) {
+				node_type* temp = ptr; ptr = ptr->next_m;
+				allocator_traits<Allocator>::destroy(alloc_m, temp->data() + temp->begin_m, temp->data() + temp->end_m);
+				allocator_traits<Allocator>::destroy(alloc_m, temp);
+				alloc_m.deallocate(temp, 1);
+			}
+			size_m = 0;
+			first_m = last_m = nullptr;
+		}
+		bool empty() const noexcept { return size_m == 0; }
+		size_type size() const { return size_m; }
+		void swap(unrolled_list& l) {
+			iml::swap(alloc_m, l.alloc_m);
+			iml::swap(first_m, l.first_m);
+			iml::swap(last_m, l.last_m);
+			iml::swap(size_m, l.size_m);
+		}
+		// 内部イテレータ(ノード毎に連続した領域を走査する)
+		template <class F>
+		F for_each(F f) {
+			for (node_type* ptr = first_m; ptr != nullptr; ptr = ptr->next_m)
+				for (T *p = ptr->data() + ptr->begin_m, *last = ptr->data() + ptr->end_m; p != last; ++p) f(*p);
+			return f;
+		}
+		template <class F>
+		F for_each(F f) const {
+			for (const node_type* ptr = first_m; ptr != nullptr; ptr = ptr->next_m)
+				for (const T *p = ptr->data() + ptr->begin_m, *last = ptr->data() + ptr->end_m; p != last; ++p) f(*p);
+			return f;
+		}
+
+
+		//  要素の挿入(挿入した要素を指すイテレータを返す)
+		iterator insert(const_iterator p, const T& v) { return emplace(p, v); }
+		iterator insert(const_iterator p, T&& v) { return emplace(p, move(v)); }
+		template <class... Types>
+		iterator emplace(const_iterator p, Types&&... args) {
+			//  vが自身の要素であるときのために予め構築する
+			T temp(forward<Types>(args)...);
+			if (p.node_m == nullptr) {
+				create_node(nullptr, nullptr, 0);
+				return insert_node(first_m, 0, move(temp));
+			}
+			return insert_node(p.node_m, p.index(), move(temp));
+		}
+		//  [first, last)
+		template <class InputIterator>
+		iterator insert(const_iterator p, InputIterator first, InputIterator last) {
+			static_assert(is_iterator_v<InputIterator, input_iterator_tag>, "The type of iterator is different.");
+
+			if (first == last) return to_iterator(p);
+			iterator itr = insert(p, *first);
+			size_type n = 1;
+			for (++first; first != last; ++first, ++n) itr = insert(++itr, *first);
+			//  ノードの分割により最初に挿入した要素が移動している可能性があるため最後の要素から戻る
+			return prev(itr, n - 1);
+		}
+		//  要素の削除(削除した要素の次を指すイテレータを返す)
+		iterator erase(const_iterator p) {
+			node_type* node = p.node_m;
+			size_t index = p.index();
+			T* data = node->data();
+			//  ノード内で移動する要素が少ない側を詰める
+			if (index - node->begin_m < node->end_m - index - 1) {
+				move_reverse_order(data + node->begin_m + 1, data + node->begin_m, data + index);
+				allocator_traits<Allocator>::destroy(alloc_m, data + node->begin_m);
+				++node->begin_m;
+				++index;
+			}
+			else {
+				move_order(data + index, data + index + 1, data + node->end_m);
+				allocator_traits<Allocator>::destroy(alloc_m, data + node->end_m - 1);
+				--node->end_m;
+			}
+			--size_m;
+			//  ノードが空になったときは解放する
+			if (node->size() == 0) {
+				node_type* temp = node->next_m;
+				remove_node(node);
+				return (temp == nullptr) ? end() : iterator(temp, temp->data() + temp->begin_m);
+			}
+			if ((index == node->end_m) && (node->next_m != nullptr)) return iterator(node->next_m, node->next_m->data() + node->next_m->begin_m);
+			return iterator(node, data + index);
+		}
+		//  [first, last)
+		iterator erase(const_iterator first, const_iterator last) {
+			if (first == last) return to_iterator(last);
+			node_type* node = first.node_m;
+			//  同一のノード内の範囲ならば後ろを詰める
+			if (node == last.node_m) {
+				T* data = node->data();
+				size_t i = first.index(), j = last.index();
+				move_order(data + i, data + j, data + node->end_m);
+				allocator_traits<Allocator>::destroy(alloc_m, data + node->end_m - (j - i), data + node->end_m);
+				node->end_m -= j - i;
+				size_m -= j - i;
+				if (node->size() == 0) {
+					node_type* temp = node->next_m;
+					remove_node(node);
+					return (temp == nullptr) ? end() : iterator(temp, temp->data() + temp->begin_m);
+				}
+				if ((i == node->end_m) && (node->next_m != nullptr)) return iterator(node->next_m, node->next_m->data() + node->next_m->begin_m);
+				return iterator(node, data + i);
+			}
+			//  firstのノードの後半を除去
+			size_t i = first.index();
+			allocator_traits<Allocator>::destroy(alloc_m, node->data() + i, node->data() + node->end_m);
+			size_m -= node->end_m - i;
+			node->end_m = i;
+			node_type* ptr = node->next_m;
+			if (node->size() == 0) remove_node(node);
+			//  間のノードを全て除去
+			while (ptr != last.node_m) {
+				node_type* temp = ptr; ptr = ptr->next_m;
+				allocator_traits<Allocator>::destroy(alloc_m, temp->data() + temp->begin_m, temp->data() + temp->end_m);
+				size_m -= temp->size();
+				remove_node(temp);
+			}
+			//  lastのノードの前半を除去
+			size_t j = last.index();
+			allocator_traits<Allocator>::destroy(alloc_m, ptr->data() + ptr->begin_m, ptr->data() + j);
+			size_m -= j - ptr->begin_m;
+			ptr->begin_m = j;
+			if (ptr->size() == 0) {
+				node_type* temp = ptr->next_m;
+				remove_node(ptr);
+				return (temp == nullptr) ? end() : iterator(temp, temp->data() + temp->begin_m);
+			}
+			return iterator(ptr, ptr->data() + j);
+		}
+
+
+		// 前後への挿入
+		unrolled_list& push_front(const T& v) { emplace_front(v); return *this; }
+		unrolled_list& push_front(T&& v) { emplace_front(move(v)); return *this; }
+		unrolled_list& push_back(const T& v) { emplace_back(v); return *this; }
+		unrolled_list& push_back(T&& v) { emplace_back(move(v)); return *this; }
+		template <class... Types>
+		reference emplace_front(Types&&... args) {
+			//  先頭のノードの前に空きがなければ後ろから詰めるノードを追加する
+			if ((first_m == nullptr) || (first_m->begin_m == 0)) {
+				node_type* temp = alloc_m.allocate(1);
+				allocator_traits<Allocator>::construct(alloc_m, temp, nullptr, first_m, N);
+				try { allocator_traits<Allocator>::construct(alloc_m, temp->data() + N - 1, forward<Types>(args)...); }
+				catch (...) {
+					allocator_traits<Allocator>::destroy(alloc_m, temp);
+					alloc_m.deallocate(temp, 1);
+					throw;
+				}
+				if (first_m == nullptr) last_m = temp;
+				else first_m->prev_m = temp;
+				first_m = temp;
+			}
+			else allocator_traits<Allocator>::construct(alloc_m, first_m->data() + first_m->begin_m - 1, forward<Types>(args)...);
+			--first_m->begin_m;
+			++size_m;
+			return first_m->data()[first_m->begin_m];
+		}
+		template <class... Types>
+		reference emplace_back(Types&&... args) {
+			//  最後のノードの後ろに空きがなければ前から詰めるノードを追加する
+			if ((last_m == nullptr) || (last_m->end_m == N)) {
+				node_type* temp = alloc_m.allocate(1);
+				allocator_traits<Allocator>::construct(alloc_m, temp, last_m, nullptr, 0);
+				try { allocator_traits<Allocator>::construct(alloc_m, temp->data(), forward<Types>(args)...); }
+				catch (...) {
+					allocator_traits<Allocator>::destroy(alloc_m, temp);
+					alloc_m.deallocate(temp, 1);
+					throw;
+				}
+				if (last_m == nullptr) first_m = temp;
+				else last_m->next_m = temp;
+				last_m = temp;
+			}
+			else allocator_traits<Allocator>::construct(alloc_m, last_m->data() + last_m->end_m, forward<Types>(args)...);
+			++last_m->end_m;
+			++size_m;
+			return last_m->data()[last_m->end_m - 1];
+		}
+		unrolled_list& pop_front() {
+			if (size_m == 0) return *this;
+
+			allocator_traits<Allocator>::destroy(alloc_m, first_m->data() + first_m->begin_m);
+			++first_m->begin_m;
+			if (first_m->size() == 0) remove_node(first_m);
+			--size_m;
+			return *this;
+		}
+		unrolled_list& pop_back() {
+			if (size_m == 0) return *this;
+
+			--last_m->end_m;
+			allocator_traits<Allocator>::destroy(alloc_m, last_m->data() + last_m->end_m);
+			if (last_m->size() == 0) remove_node(last_m);
+			--size_m;
+			return *this;
+		}
+
+		//  代入(ノード単位で複製するため要素の配置も同一となる)
+		unrolled_list& operator=(const unrolled_list& l) {
+			if (this == addressof(l)) return *this;
+			clear();
+			for (const node_type* ptr = l.first_m; ptr != nullptr; ptr = ptr->next_m) {
+				node_type* temp = create_node(last_m, nullptr, ptr->begin_m);
+				allocator_traits<Allocator>::copy_construct(alloc_m, temp->data() + ptr->begin_m, temp->data() + ptr->end_m, ptr->data() + ptr->begin_m, ptr->data() + ptr->end_m);
+				temp->end_m = ptr->end_m;
+				size_m += ptr->size();
+			}
+			return *this;
+		}
+		unrolled_list& operator=(unrolled_list&& l) {
+			if (this == addressof(l)) return *this;
+			clear();
+			first_m = l.first_m; last_m = l.last_m;
+			alloc_m = l.alloc_m;
+			size_m = l.size_m;
+			l.first_m = l.last_m = nullptr;
+			l.size_m = 0;
+			return *this;
+		}
+
+		//  ノード単位で読み飛ばすためO(size() / N)
+		T& operator[](size_type index) noexcept {
+			node_type* ptr = first_m;
+			for (; index >= ptr->size(); ptr = ptr->next_m) index -= ptr->size();
+			return ptr->data()[ptr->begin_m + index];
+		}
+		const T& operator[](size_type index) const noexcept {
+			const node_type* ptr = first_m;
+			for (; index >= ptr->size(); ptr = ptr->next_m) index -= ptr->size();
+			return ptr->data()[ptr->begin_m + index];
+		}
+
+		// 前後へのアクセス
+		T& front() { return first_m->data()[first_m->begin_m]; }
+		const T& front() const { return first_m->data()[first_m->begin_m]; }
+		T& back() { return last_m->data()[last_m->end_m - 1]; }
+		const T& back() const { return last_m->data()[last_m->end_m - 1]; }
+	};
+
+
+	//  memory_resourceにより実行時にメモリ確保の方法を切り替えるコンテナ
+	namespace pmr {
+		template <class T, size_t N = unrolled_list_default_node_size<T>>
+		using unrolled_list = iml::unrolled_list<T, N, polymorphic_allocator<unrolled_list_node<T, N>>>;
+	}
+
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,122 @@
+﻿#ifndef IMATHLIB_CONTAINER_WORK_STEALING_DEQUE_HPP
+#define IMATHLIB_CONTAINER_WORK_STEALING_DEQUE_HPP
+
+#include "IMathLib/container/allocator.hpp"
+#include "IMathLib/container/concurrent_queue.hpp"
+#include <atomic>
+
+
+//  Chase-Levのワークスティーリング両端キュー
+namespace iml {
+
+	//  所有者のスレッドは下端でpush/popを行い他のスレッドは上端からstealする
+	//  要素は他のスレッドから競合して読まれるためトリビアルにコピー可能な型(タスクへのポインタ等)に限る
+	template <class T, class Allocator = allocator<std::atomic<T>>>
+	class work_stealing_deque {
+		static_assert(is_trivially_copyable_v<T>, "T must be trivially copyable.");
+	public:
+		using value_type = T;
+		using allocator_type = Allocator;
+		using size_type = typename allocator_traits<Allocator>::size_type;
+	private:
+		//  循環配列(拡張した後も他のスレッドが参照している可能性があるため古い配列は破棄時まで保持する)
+		struct buffer {
+			std::atomic<T>*		p_m;
+			size_type			size_m;			//  2の冪
+			buffer*				prev_m;			//  拡張する前の配列
+
+			T get(ptrdiff_t i) const noexcept { return p_m[static_cast<size_type>(i) & (size_m - 1)].load(std::memory_order_relaxed); }
+			void put(ptrdiff_t i, T v) noexcept { p_m[static_cast<size_type>(i) & (size_m - 1)].store(v, std::memory_order_relaxed); }
+		};
+
+		alignas(cache_line_size) std::atomic<ptrdiff_t>	top_m;			//  stealする位置
+		alignas(cache_line_size) std::atomic<ptrdiff_t>	bottom_m;		//  次にpushする位置
+		std::atomic<buffer*>							buffer_m;
+		Allocator										alloc_m;
+
+		buffer* create_buffer(size_type size, buffer* prev) {
+			buffer* temp = new buffer{ alloc_m.allocate(size), size, prev };
+			for (size_type i = 0; i < size; ++i) ::new (static_cast<void*>(temp->p_m + i)) std::atomic<T>();
+			return temp;
+		}
+		//  [top, bottom)の要素を2倍の容量の配列へ移す
+		buffer* grow(buffer* b, ptrdiff_t top, ptrdiff_t bottom) {
+			buffer* temp = create_buffer(b->size_m * 2, b);
+			for (ptrdiff_t i = top; i < bottom; ++i) temp->put(i, b->get(i));
+			buffer_m.store(temp, std::memory_order_release);
+			return temp;
+		}
+	public:
+		explicit work_stealing_deque(size_type size = 64, const Allocator& alloc = Allocator()) : top_m(0), bottom_m(0), buffer_m(nullptr)
+			, alloc_m(allocator_traits<Allocator>::select_on_container_copy_construction(alloc)) {
+			size_type n = 2;
+			while (n < size) n <<= 1;
+			buffer_m.store(create_buffer(n, nullptr), std::memory_order_relaxed);
+		}
+		work_stealing_deque(const work_stealing_deque&) = delete;
+		~work_stealing_deque() {
+			for (buffer* ptr = buffer_m.load(std::memory_order_relaxed); ptr != nullptr;) {
+				buffer* temp = ptr; ptr = ptr->prev_m;
+				alloc_m.deallocate(temp->p_m, temp->size_m);
+				delete temp;
+			}
+		}
+
+		work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+		//  下端への追加(所有者のみ)
+		void push(T v) {
+			ptrdiff_t b = bottom_m.load(std::memory_order_relaxed);
+			ptrdiff_t t = top_m.load(std::memory_order_acquire);
+			buffer* a = buffer_m.load(std::memory_order_relaxed);
+			if (b - t > static_cast<ptrdiff_t>(a->size_m) - 1) a = grow(a, t, b);
+			a->put(b, v);
+			bottom_m.store(b + 1, std::memory_order_release);
+		}
+		//  下端からの取り出し(所有者のみ,空のときはfalse)
+		bool pop(T& v) {
+			ptrdiff_t b = bottom_m.load(std::memory_order_relaxed) - 1;
+			buffer* a = buffer_m.load(std::memory_order_relaxed);
+			bottom_m.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			ptrdiff_t t = top_m.load(std::memory_order_relaxed);
+			if (t > b) {
+				bottom_m.store(b + 1, std::memory_order_relaxed);
+				return false;
+			}
+			v = a->get(b);
+			if (t == b) {
+				//  最後の1要素はstealと競合するためtopを進めて確保する
+				bool result = top_m.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				bottom_m.store(b + 1, std::memory_order_relaxed);
+				return result;
+			}
+			return true;
+		}
+		//  上端からの取り出し(任意のスレッド,空または競合に負けたときはfalse)
+		bool steal(T& v) {
+			ptrdiff_t t = top_m.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			ptrdiff_t b = bottom_m.load(std::memory_order_acquire);
+			if (t >= b) return false;
+			buffer* a = buffer_m.load(std::memory_order_acquire);
+			T temp = a->get(t);
+			if (!top_m.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return false;
+			v = temp;
+			return true;
+		}
+
+		//  他のスレッドが操作中であれば概算となる
+		size_type size() const noexcept {
+			ptrdiff_t b = bottom_m.load(std::memory_order_relaxed);
+			ptrdiff_t t = top_m.load(std::memory_order_relaxed);
+			return (b > t) ? static_cast<size_type>(b - t) : 0;
+		}
+		bool empty() const noexcept { return size() == 0; }
+		size_type capacity() const noexcept { return buffer_m.load(std::memory_order_relaxed)->size_m; }
+	};
+
+}
+
+
+#endif
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include "IMathLib/media/image/image.hpp"
 #include "IMathLib/utility/tuple.hpp"
 #include "IMathLib/media/common/enabler_object.hpp"
+#include "IMathLib/container/hash_map.hpp"
+#include "IMathLib/utility/intrusive_ptr.hpp"
 #include <vector>
 #include <unordered_map>
 #include <list>
@@ -187,7 +189,7 @@ namespace iml {
 
 		// テクスチャとそれを
 		class texture;
-		using shared_texture = std::shared_ptr<texture>;
+		using shared_texture = intrusive_ptr<texture>;
 
 		class texture_unit_impl;
 		using texture_unit = std::shared_ptr<texture_unit_impl>;
@@ -203,7 +205,7 @@ namespace iml {
 			// data2_m:テクスチャIDとテクスチャユニットの番号の関連付け(全てのテクスチャIDを保持する)
 			// data3_m:古い順にリバインドされるためのデータリスト(data1_mとは0番目の要素を除いて一対一対応)
 			static inline std::vector<texture_unit>				data1_m;		// 添え字はテクスチャユニット番号
-			static inline std::unordered_map<GLuint, int_t>		data2_m;		// Key:テクスチャID, Value:テクスチャユニット番号
+			static inline hash_map<GLuint, int_t>				data2_m;		// Key:テクスチャID, Value:テクスチャユニット番号
 			static inline std::list<int_t>						data3_m;		// テクスチャユニット番号のリスト
 
 			static inline GLint						color_buffer_num_m;			// 利用可能なカラーバッファの数
@@ -234,7 +236,7 @@ namespace iml {
 
 
 		// テクスチャ
-		class texture {
+		class texture : public intrusive_ref_counter<texture> {
 			GLuint	id_m;
 			size_t	width_m, height_m;
 			GLint	format_m;
@@ -691,7 +693,7 @@ namespace iml {
 
 
 		// レンダーバッファのためのオブジェクト
-		class render_buffer {
+		class render_buffer : public intrusive_ref_counter<render_buffer> {
 			friend class frame_buffer_object;
 
 			GLuint	id_m;
@@ -759,9 +761,9 @@ namespace iml {
 				glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, screen_rect::frame_buffer_object_id());
 			}
 		};
-		using shared_render_buffer = std::shared_ptr<render_buffer>;
+		using shared_render_buffer = intrusive_ptr<render_buffer>;
 		// テクスチャバッファのためのオブジェクト
-		class texture_buffer {
+		class texture_buffer : public intrusive_ref_counter<texture_buffer> {
 			friend class frame_buffer_object;
 
 			shared_texture		tex_m;
@@ -813,7 +815,7 @@ namespace iml {
 				glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, screen_rect::frame_buffer_object_id());
 			}
 		};
-		using shared_texture_buffer = std::shared_ptr<texture_buffer>;
+		using shared_texture_buffer = intrusive_ptr<texture_buffer>;
 
 		// フレームバッファオブジェクト(全てのテクスチャバッファは同一のサイズであるべき)
 		class frame_buffer_object {
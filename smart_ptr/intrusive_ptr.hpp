@@ -0,0 +1,105 @@
+﻿#ifndef IMATHLIB_H_UTILITY_INTRUSIVE_PTR_HPP
+#define IMATHLIB_H_UTILITY_INTRUSIVE_PTR_HPP
+
+#include "IMathLib/utility/smart_ptr.hpp"
+
+
+// 参照カウンタをインスタンス自身が保持するスマートポインタ
+namespace iml {
+
+	// intrusive_ptrで管理する型の基底
+	// Derived:派生クラス, Policy:参照カウンタの操作方法(単一のスレッドでのみ用いるときはsingle_thread_count_policy)
+	// intrusive_ptrはADLによりintrusive_ptr_add_ref/intrusive_ptr_releaseを呼び出すため,独自の参照カウンタをもつ型はこれらを定義すればよい
+	template <class Derived, class Policy = atomic_count_policy>
+	class intrusive_ref_counter {
+		mutable typename Policy::counter_type	cnt_m;			// 参照カウンタ
+	protected:
+		constexpr intrusive_ref_counter() noexcept : cnt_m(0) {}
+		// コピーやムーブをしても参照カウンタは引き継がない
+		intrusive_ref_counter(const intrusive_ref_counter&) noexcept : cnt_m(0) {}
+		~intrusive_ref_counter() {}
+
+		intrusive_ref_counter& operator=(const intrusive_ref_counter&) noexcept { return *this; }
+	public:
+		// 参照している数
+		size_t use_count() const noexcept { return Policy::load(cnt_m); }
+
+		friend void intrusive_ptr_add_ref(const intrusive_ref_counter* p) noexcept { Policy::inc(p->cnt_m); }
+		friend void intrusive_ptr_release(const intrusive_ref_counter* p) noexcept {
+			if (Policy::dec(p->cnt_m) == 0) delete static_cast<const Derived*>(p);
+		}
+	};
+
+
+	// 所有権をシェアするスマートポインタ(参照カウンタをインスタンスが保持するためポインタ1つ分の大きさとなる)
+	template <class T>
+	class intrusive_ptr {
+		template <class>
+		friend class intrusive_ptr;
+
+		T*	p_m;		// 保持しているインスタンス
+	public:
+		using element_type = T;
+
+		constexpr intrusive_ptr() noexcept : p_m(nullptr) {}
+		// add_ref:参照カウンタを増加させるか(既に参照を保持しているポインタを引き取るときはfalse)
+		explicit intrusive_ptr(T* p, bool add_ref = true) : p_m(p) { if ((p_m != nullptr) && add_ref) intrusive_ptr_add_ref(p_m); }
+		intrusive_ptr(const intrusive_ptr& p) : p_m(p.p_m) { if (p_m != nullptr) intrusive_ptr_add_ref(p_m); }
+		intrusive_ptr(intrusive_ptr&& p) noexcept : p_m(p.p_m) { p.p_m = nullptr; }
+		template <class U>
+		intrusive_ptr(const intrusive_ptr<U>& p) : p_m(static_cast<T*>(p.p_m)) { if (p_m != nullptr) intrusive_ptr_add_ref(p_m); }
+		template <class U>
+		intrusive_ptr(intrusive_ptr<U>&& p) noexcept : p_m(static_cast<T*>(p.p_m)) { p.p_m = nullptr; }
+		~intrusive_ptr() { if (p_m != nullptr) intrusive_ptr_release(p_m); }
+
+		// スワップ
+		void swap(intrusive_ptr& p) noexcept { iml::swap(p_m, p.p_m); }
+
+		// 所有権を破棄して新しい所有権を得る
+		void reset() { intrusive_ptr().swap(*this); }
+		void reset(T* p, bool add_ref = true) { intrusive_ptr(p, add_ref).swap(*this); }
+		// 参照カウンタを減少させずに所有権を手放す
+		T* detach() noexcept {
+			T* temp = p_m;
+			p_m = nullptr;
+			return temp;
+		}
+
+		// 代入演算
+		intrusive_ptr& operator=(const intrusive_ptr& p) {
+			intrusive_ptr(p).swap(*this);
+			return *this;
+		}
+		intrusive_ptr& operator=(intrusive_ptr&& p) noexcept {
+			intrusive_ptr(move(p)).swap(*this);
+			return *this;
+		}
+		template <class U>
+		intrusive_ptr& operator=(const intrusive_ptr<U>& p) {
+			intrusive_ptr(p).swap(*this);
+			return *this;
+		}
+		template <class U>
+		intrusive_ptr& operator=(intrusive_ptr<U>&& p) noexcept {
+			intrusive_ptr(move(p)).swap(*this);
+			return *this;
+		}
+
+
+		// 各種参照
+		T* get() const noexcept { return p_m; }
+		T& operator*() const { return *get(); }
+		T* operator->() const { return get(); }
+
+		// リソースを所持しているかの判定
+		operator bool() const { return !!p_m; }
+		bool operator!() const { return !p_m; }
+	};
+	template <class T, class U>
+	inline bool operator==(const intrusive_ptr<T>& p1, const intrusive_ptr<U>& p2) { return p1.get() == p2.get(); }
+	template <class T, class U>
+	inline bool operator!=(const intrusive_ptr<T>& p1, const intrusive_ptr<U>& p2) { return p1.get() != p2.get(); }
+}
+
+
+#endif
\ No newline at end of file
@@ -2,75 +2,204 @@
 #define IMATHLIB_H_UTILITY_SMART_PTR_HPP
 
 #include "IMathLib/container/allocator.hpp"
+#include <atomic>
+#include <type_traits>
+
+
+// 参照カウンタの操作方法
+namespace iml {
+
+	// 複数のスレッドでリソースを共有する(既定)
+	struct atomic_count_policy {
+		using counter_type = std::atomic<size_t>;
+
+		// 増加は他の操作との順序付けを必要としない
+		static size_t inc(counter_type& c) noexcept { return c.fetch_add(1, std::memory_order_relaxed) + 1; }
+		// 減少はリソースの破棄より前に他のスレッドで行われた操作を可視にする
+		static size_t dec(counter_type& c) noexcept { return c.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+		// 0でないときのみ増加(weak_ptrからの復元用)
+		static bool inc_if_nonzero(counter_type& c) noexcept {
+			size_t n = c.load(std::memory_order_relaxed);
+			while (n != 0)
+				if (c.compare_exchange_weak(n, n + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) return true;
+			return false;
+		}
+		static size_t load(const counter_type& c) noexcept { return c.load(std::memory_order_acquire); }
+	};
+	// 単一のスレッドでのみリソースを共有する(原子的操作を省略する)
+	struct single_thread_count_policy {
+		using counter_type = size_t;
+
+		static size_t inc(counter_type& c) noexcept { return ++c; }
+		static size_t dec(counter_type& c) noexcept { return --c; }
+		static bool inc_if_nonzero(counter_type& c) noexcept {
+			if (c == 0) return false;
+			++c;
+			return true;
+		}
+		static size_t load(const counter_type& c) noexcept { return c; }
+	};
+
+	template <class T, class Policy = atomic_count_policy>
+	class shared_ptr;
+	template <class T, class Policy = atomic_count_policy>
+	class weak_ptr;
+	template <class T, class Policy = atomic_count_policy, class Allocator, class... Types>
+	shared_ptr<T, Policy> allocate_shared(const Allocator& alloc, Types&&... args);
+}
 
 
 // インスタンスの所有権が唯一なスマートポインタ
 namespace iml {
 
+	// deleteによる破棄
+	template <class T>
+	struct default_delete {
+		constexpr default_delete() noexcept {}
+		template <class U>
+		default_delete(const default_delete<U>&) noexcept {}
+
+		void operator()(T* p) const { delete p; }
+	};
+	// delete[]による破棄
 	template <class T>
+	struct default_delete<T[]> {
+		constexpr default_delete() noexcept {}
+
+		void operator()(T* p) const { delete[] p; }
+	};
+	// deallocatorを通して破棄する(型消去のため確保と仮想関数呼び出しを伴うので明示的に指定したときのみ用いる)
+	struct erased_delete {
+		deallocator_base*	dealloc_m;
+
+		constexpr erased_delete() noexcept : dealloc_m(nullptr) {}
+		explicit erased_delete(deallocator_base* dealloc) noexcept : dealloc_m(dealloc) {}
+		erased_delete(const erased_delete&) = delete;
+		erased_delete(erased_delete&& d) noexcept : dealloc_m(d.dealloc_m) { d.dealloc_m = nullptr; }
+		~erased_delete() { if (dealloc_m != nullptr) dealloc_m->release(); }
+
+		void operator()(void*) const { if (dealloc_m != nullptr) dealloc_m->dispose(); }
+
+		erased_delete& operator=(const erased_delete&) = delete;
+		erased_delete& operator=(erased_delete&& d) noexcept {
+			if (this != &d) {
+				if (dealloc_m != nullptr) dealloc_m->release();
+				dealloc_m = d.dealloc_m;
+				d.dealloc_m = nullptr;
+			}
+			return *this;
+		}
+	};
+
+	// 保持しているポインタとDeleter(空のDeleterは空の基底クラスの最適化により領域をもたない)
+	template <class T, class Deleter, bool = std::is_empty_v<Deleter> && !std::is_final_v<Deleter>>
+	class unique_ptr_storage : private Deleter {
+	public:
+		T*	p_m;
+
+		constexpr unique_ptr_storage(T* p) noexcept : Deleter(), p_m(p) {}
+		template <class D>
+		unique_ptr_storage(T* p, D&& d) noexcept : Deleter(forward<D>(d)), p_m(p) {}
+
+		Deleter& deleter() noexcept { return *this; }
+		const Deleter& deleter() const noexcept { return *this; }
+	};
+	template <class T, class Deleter>
+	class unique_ptr_storage<T, Deleter, false> {
+		Deleter		d_m;
+	public:
+		T*	p_m;
+
+		constexpr unique_ptr_storage(T* p) noexcept : d_m(), p_m(p) {}
+		template <class D>
+		unique_ptr_storage(T* p, D&& d) noexcept : d_m(forward<D>(d)), p_m(p) {}
+
+		Deleter& deleter() noexcept { return d_m; }
+		const Deleter& deleter() const noexcept { return d_m; }
+	};
+
+	// Deleter:インスタンスを破棄する関数オブジェクト(既定ではdeleteを直接呼び出すため確保と仮想関数呼び出しを伴わない)
+	template <class T, class Deleter = default_delete<T>>
 	class unique_ptr {
-		template <class>
+		template <class, class>
 		friend class shared_ptr;
-		template <class>
+		template <class, class>
 		friend class unique_ptr;
 
-		T*					p_m;			// 保持しているインスタンス
-		deallocator_base*	dealloc_m;		// ディアロケータ
+		unique_ptr_storage<T, Deleter>	s_m;		// 保持しているインスタンスとディリータ
 	public:
-		constexpr unique_ptr() noexcept : p_m(nullptr), dealloc_m(nullptr) {}
-		unique_ptr(unique_ptr&& u) noexcept : p_m(u.p_m), dealloc_m(u.dealloc_m) { u.p_m = nullptr; u.dealloc_m = nullptr; }
+		using element_type = T;
+		using deleter_type = Deleter;
+
+		constexpr unique_ptr() noexcept : s_m(nullptr) {}
+		unique_ptr(unique_ptr&& u) noexcept : s_m(u.s_m.p_m, move(u.s_m.deleter())) { u.s_m.p_m = nullptr; }
+		template <class U, class E>
+		unique_ptr(unique_ptr<U, E>&& u) noexcept : s_m(static_cast<T*>(u.s_m.p_m), move(u.s_m.deleter())) { u.s_m.p_m = nullptr; }
 		template <class U>
-		unique_ptr(unique_ptr<U>&& u) noexcept : p_m(static_cast<T*>(u.p_m)), dealloc_m(u.dealloc_m) { u.p_m = nullptr; u.dealloc_m = nullptr; }
+		explicit unique_ptr(U* p) noexcept : s_m(static_cast<T*>(p)) {
+			static_assert(!is_same_v<Deleter, erased_delete>, "erased_delete requires dealloc_ident.");
+		}
+		template <class U>
+		unique_ptr(U* p, const Deleter& d) noexcept : s_m(static_cast<T*>(p), d) {}
 		template <class U>
-		explicit unique_ptr(U* p) : p_m(static_cast<T*>(p)), dealloc_m(deallocator<T, dealloc::variable>::get(p)) {}
+		unique_ptr(U* p, Deleter&& d) noexcept : s_m(static_cast<T*>(p), move(d)) {}
+		// deallocatorによる破棄(Deleterがerased_deleteのときのみ)
 		template <class U, size_t N, class... Types>
-		explicit unique_ptr(U* p, dealloc_ident<N>, Types&&... args) : p_m(static_cast<T*>(p)), dealloc_m(deallocator<T, N>::get(p, forward<Types>(args)...)) {}
-		~unique_ptr() { dealloc_m->destroy(); }
+		explicit unique_ptr(U* p, dealloc_ident<N>, Types&&... args) : s_m(static_cast<T*>(p), Deleter(deallocator<T, N>::get(p, forward<Types>(args)...))) {
+			static_assert(is_same_v<Deleter, erased_delete>, "The deleter must be erased_delete.");
+		}
+		~unique_ptr() { if (s_m.p_m != nullptr) s_m.deleter()(s_m.p_m); }
 
 		void swap(unique_ptr& x) noexcept {
-			iml::swap(p_m, x.p_m); iml::swap(dealloc_m, x.dealloc_m);
+			iml::swap(s_m.p_m, x.s_m.p_m); iml::swap(s_m.deleter(), x.s_m.deleter());
 		}
 		// インスタンスの所有権を破棄(解放はしない)
 		T* release() noexcept {
-			T* temp = p_m;
-			if (!dealloc_m) {
-				dealloc_m->release();
-				dealloc_m = nullptr;
-			}
-			p_m = nullptr;
+			T* temp = s_m.p_m;
+			s_m.p_m = nullptr;
 			return temp;
 		}
 		// インスタンスの破棄
-		void reset() { unique_ptr().swap(*this); }
+		void reset() { reset(static_cast<T*>(nullptr)); }
 		// インスタンスを破棄して再設定
 		template <class U>
-		void reset(U* p) { unique_ptr(p).swap(*this); }
+		void reset(U* p) {
+			// erased_deleteのdeallocatorは保持しているポインタを記録しているため作り直す
+			if constexpr (is_same_v<Deleter, erased_delete>) {
+				if (p == nullptr) unique_ptr().swap(*this);
+				else unique_ptr(p, dealloc_ident<dealloc::variable>()).swap(*this);
+			}
+			else {
+				T* temp = s_m.p_m;
+				s_m.p_m = static_cast<T*>(p);
+				if (temp != nullptr) s_m.deleter()(temp);
+			}
+		}
 		template <class U, size_t N, class... Types>
-		void reset(U* p, dealloc_ident<N> id = dealloc_ident<N>(), Types&&... args) {
+		void reset(U* p, dealloc_ident<N> id, Types&&... args) {
 			unique_ptr(p, id, forward<Types>(args)...).swap(*this);
 		}
 
 		unique_ptr& operator=(const unique_ptr&) = delete;
 		unique_ptr& operator=(unique_ptr&& u) noexcept {
-			if (this != &u) {
-				p_m = u.p; u.p_m = nullptr;
-				dealloc_m = u.dealloc_m; u.dealloc_m = nullptr;
-			}
+			if (this != &u) unique_ptr(move(u)).swap(*this);
 			return *this;
 		}
 
 
 		// 各種参照
-		T* get() const { return p_m; }
+		T* get() const { return s_m.p_m; }
 		T& operator*() const { return *get(); }
 		T* operator->() const { return get(); }
+		Deleter& get_deleter() noexcept { return s_m.deleter(); }
+		const Deleter& get_deleter() const noexcept { return s_m.deleter(); }
 
 		// リソースを所持しているかの判定
-		operator bool() const { return !!p_m; }
-		bool operator!() const { return !p_m; }
+		operator bool() const { return !!s_m.p_m; }
+		bool operator!() const { return !s_m.p_m; }
 
-		const T& operator[](size_t index) const { return p_m[index]; }
-		T& operator[](size_t index) { return p_m[index]; }
+		const T& operator[](size_t index) const { return s_m.p_m[index]; }
+		T& operator[](size_t index) { return s_m.p_m[index]; }
 	};
 }
 
@@ -80,66 +209,142 @@ namespace iml {
 namespace iml {
 
 	// 参照カウンタ
+	// weak_cnt_mはシェアしているもの全体で1つ分を保持し，シェアカウンタが0になったときに手放す
+	template <class Policy>
 	struct shared_count_impl {
-		size_t					shared_cnt_m;		// シェアカウンタ
-		size_t					weak_cnt_m;			// ウィークカウンタ
-		deallocator_base*		dealloc_m;			// リソースを参照してその破棄の中継をする
+		typename Policy::counter_type	shared_cnt_m;		// シェアカウンタ
+		typename Policy::counter_type	weak_cnt_m;			// ウィークカウンタ
+
+		shared_count_impl() : shared_cnt_m(1), weak_cnt_m(1) {}
+		shared_count_impl(const shared_count_impl&) = delete;
+		virtual ~shared_count_impl() {}
+
+		// リソースの破棄
+		virtual void dispose() = 0;
+		// 自身の解放
+		virtual void destroy() = 0;
+
+		size_t inc() { return Policy::inc(shared_cnt_m); }
+		size_t dec() { return Policy::dec(shared_cnt_m); }			// 仕様上，負数になることはない
+		bool inc_if_nonzero() { return Policy::inc_if_nonzero(shared_cnt_m); }
+		size_t weak_inc() { return Policy::inc(weak_cnt_m); }
+		size_t weak_dec() { return Policy::dec(weak_cnt_m); }
+		size_t shared_count() const { return Policy::load(shared_cnt_m); }
+		size_t weak_count() const {
+			size_t n = Policy::load(weak_cnt_m);
+			return (shared_count() != 0) ? n - 1 : n;
+		}
 
+		// シェアカウンタが0になったときリソースを破棄し，ウィークカウンタも0ならば自身を解放
+		void release_shared() {
+			if (dec() != 0) return;
+			dispose();
+			release_weak();
+		}
+		// ウィークカウンタが0ならば自身を解放
+		void release_weak() {
+			if (weak_dec() == 0) destroy();
+		}
+
+		shared_count_impl& operator=(const shared_count_impl&) = delete;
+	};
+	// deallocatorを通してリソースを破棄する参照カウンタ
+	template <class Policy>
+	class shared_count_dealloc : public shared_count_impl<Policy> {
+		deallocator_base*	dealloc_m;			// リソースを参照してその破棄の中継をする
+	public:
 		// p:保持しているリソースへのポインタ
 		// N:deallocatorの種類を示す定数
 		template <class T, size_t N, class... Types>
-		explicit shared_count_impl(T* p, dealloc_ident<N>, Types&&... args) : shared_cnt_m(1), weak_cnt_m(0), dealloc_m(deallocator<T, N>::get(p, forward<Types>(args)...)) {}
+		explicit shared_count_dealloc(T* p, dealloc_ident<N>, Types&&... args) : dealloc_m(deallocator<T, N>::get(p, forward<Types>(args)...)) {}
 		template <class T>
-		explicit shared_count_impl(T* p, deallocator_base* dealloc) : shared_cnt_m(1), weak_cnt_m(0), dealloc_m(dealloc) {}
-		shared_count_impl(const shared_count_impl& c)  noexcept : shared_cnt_m(c.shared_cnt_m), weak_cnt_m(c.weak_cnt_m), dealloc_m(c.dealloc_m) {}
-		shared_count_impl(shared_count_impl&& c)  noexcept : shared_cnt_m(c.shared_cnt_m), weak_cnt_m(c.weak_cnt_m), dealloc_m(c.dealloc_m) { c.dealloc_m = nullptr; }
-		~shared_count_impl() { dealloc_m->destroy(); }
-
-		size_t inc() { return ++shared_cnt_m; }
-		size_t dec() { return --shared_cnt_m; }					// 仕様上，負数になることはない
-		size_t weak_inc() { return ++weak_cnt_m; }
-		size_t weak_dec() { return --weak_cnt_m; }
-		size_t shared_count() { return shared_cnt_m; }
-		size_t weak_count() { return weak_cnt_m; }
+		explicit shared_count_dealloc(T* p, deallocator_base* dealloc) : dealloc_m(dealloc) {}
+		// リソースはシェアカウンタが0になったときに破棄済み
+		~shared_count_dealloc() { if (dealloc_m != nullptr) dealloc_m->release(); }
 
-		shared_count_impl& operator=(const shared_count_impl&) = delete;
-		shared_count_impl& operator=(shared_count_impl&& c) noexcept {
-			this->shared_cnt_m = c.shared_cnt_m;
-			this->weak_cnt_m = c.weak_cnt_m;
-			this->dealloc_m = c.dealloc_m;
-			c.dealloc_m = nullptr;
-			return *this;
+		void dispose() { dealloc_m->dispose(); }
+		void destroy() { delete this; }
+	};
+	// Deleterによりリソースを破棄する参照カウンタ(unique_ptrからの変換による)
+	template <class T, class Deleter, class Policy>
+	class shared_count_deleter final : public shared_count_impl<Policy> {
+		T*			p_m;
+		Deleter		d_m;
+	public:
+		shared_count_deleter(T* p, Deleter&& d) : p_m(p), d_m(move(d)) {}
+
+		void dispose() { if (p_m != nullptr) d_m(p_m); }
+		void destroy() { delete this; }
+	};
+	// リソースを参照カウンタと同一の領域に構築する参照カウンタ(allocate_sharedによる)
+	// リソースの型が既知であるため破棄はdeallocatorを経由しない
+	template <class T, class Allocator, class Policy>
+	class shared_count_inplace final : public shared_count_impl<Policy> {
+		using value_allocator = typename allocator_traits<Allocator>::template rebind_t<T>;
+		using block_allocator = typename allocator_traits<Allocator>::template rebind_t<shared_count_inplace>;
+
+		value_allocator				alloc_m;
+		alignas(T) unsigned char	storage_m[sizeof(T)];			// リソースの領域
+
+		explicit shared_count_inplace(const Allocator& alloc) : alloc_m(alloc) {}
+	public:
+		T* get() noexcept { return reinterpret_cast<T*>(storage_m); }
+
+		void dispose() { allocator_traits<value_allocator>::destroy(alloc_m, get()); }
+		void destroy() {
+			block_allocator a(alloc_m);
+			this->~shared_count_inplace();
+			a.deallocate(this, 1);
+		}
+
+		// 参照カウンタとリソースを1度の確保で構築する
+		template <class... Types>
+		static shared_count_inplace* create(const Allocator& alloc, Types&&... args) {
+			block_allocator a(alloc);
+			shared_count_inplace* p = a.allocate(1);
+			::new (static_cast<void*>(p)) shared_count_inplace(alloc);
+			try { allocator_traits<value_allocator>::construct(p->alloc_m, p->get(), forward<Types>(args)...); }
+			catch (...) {
+				p->~shared_count_inplace();
+				a.deallocate(p, 1);
+				throw;
+			}
+			return p;
 		}
 	};
+	template <class Policy>
+	class weak_count;
+	template <class Policy>
 	class shared_count {
+		template <class>
 		friend class weak_count;
 
-		shared_count_impl*	cnt_m;
+		shared_count_impl<Policy>*	cnt_m;
 	public:
 		constexpr shared_count() : cnt_m(nullptr) {}
 		shared_count(const shared_count& s)  noexcept : cnt_m(s.cnt_m) { if (cnt_m) cnt_m->inc(); }
 		shared_count(shared_count&& s)  noexcept : cnt_m(s.cnt_m) { s.cnt_m = nullptr; }
-		shared_count(const weak_count& w) noexcept;
+		shared_count(const weak_count<Policy>& w) noexcept;
 		template <class T>
-		explicit shared_count(T* p) : cnt_m(new shared_count_impl(p, dealloc_ident<dealloc::variable>())) {}
+		explicit shared_count(T* p) : cnt_m(new shared_count_dealloc<Policy>(p, dealloc_ident<dealloc::variable>())) {}
 		template <class T, size_t N, class... Types>
-		explicit shared_count(T* p, dealloc_ident<N> id, Types&&... args) : cnt_m(new shared_count_impl(p, id, forward<Types>(args)...)) {}
+		explicit shared_count(T* p, dealloc_ident<N> id, Types&&... args) : cnt_m(new shared_count_dealloc<Policy>(p, id, forward<Types>(args)...)) {}
 		// deallocは実態をもたなければならない
 		template <class T>
-		explicit shared_count(T* p, deallocator_base& dealloc) : cnt_m(new shared_count_impl(p, addressof(dealloc))) {}
+		explicit shared_count(T* p, deallocator_base& dealloc) : cnt_m(new shared_count_dealloc<Policy>(p, addressof(dealloc))) {}
+		// 構築済みの参照カウンタの所有
+		explicit shared_count(shared_count_impl<Policy>* c) noexcept : cnt_m(c) {}
 		~shared_count() { release(); }
 
-		// 弱参照とシェアカウンタが0(他にリソースを参照しているものが存在しない)ならば解放
+		// 他にリソースを参照しているものが存在しなければ解放
 		void release() {
-			if (cnt_m != nullptr)
-				if (cnt_m && !cnt_m->dec() && !cnt_m->weak_count()) {
-					cnt_m->dealloc_m->dispose();
-					delete cnt_m;
-					cnt_m = nullptr;
-				}
+			if (cnt_m != nullptr) {
+				cnt_m->release_shared();
+				cnt_m = nullptr;
+			}
 		}
 		shared_count& operator=(const shared_count& r) {
-			shared_count_impl* temp = r.cnt_m;
+			shared_count_impl<Policy>* temp = r.cnt_m;
 			// シェアカウンタが同一のものでないとき代入
 			if (temp != cnt_m) {
 				if (temp != nullptr) temp->inc();
@@ -167,29 +372,34 @@ namespace iml {
 
 
 	// 所有権をシェアするスマートポインタ
-	template <class T>
+	// Policy:参照カウンタの操作方法(単一のスレッドでのみ用いるときはsingle_thread_count_policy)
+	template <class T, class Policy>
 	class shared_ptr {
-		template <class>
+		template <class, class>
 		friend class shared_ptr;
-		template <class>
+		template <class, class>
 		friend class weak_ptr;
-		template <class>
+		template <class, class>
 		friend class unique_ptr;
+		template <class U, class P, class Allocator, class... Types>
+		friend shared_ptr<U, P> allocate_shared(const Allocator&, Types&&...);
 
 		T*				p_m;		// 保持しているインスタンス
-		shared_count	sc_m;		// シェアカウンタ
+		shared_count<Policy>	sc_m;		// シェアカウンタ
 	public:
 		constexpr shared_ptr() noexcept : p_m(nullptr), sc_m() {}
 		shared_ptr(const shared_ptr& s) noexcept : p_m(s.p_m), sc_m(s.sc_m) {}
-		shared_ptr(shared_ptr&& s) noexcept : p_m(s.p_m), sc_m(s.sc_m) { s.p_m = nullptr; }
+		shared_ptr(shared_ptr&& s) noexcept : p_m(s.p_m), sc_m(move(s.sc_m)) { s.p_m = nullptr; }
 		template<class U>
-		shared_ptr(const shared_ptr<U>& s) noexcept : p_m(const_cast<T*>(static_cast<const T*>(s.p_m))), sc_m(s.sc_m) {}
+		shared_ptr(const shared_ptr<U, Policy>& s) noexcept : p_m(const_cast<T*>(static_cast<const T*>(s.p_m))), sc_m(s.sc_m) {}
 		template<class U>
-		shared_ptr(shared_ptr<U>&& s) noexcept : p_m(static_cast<T*>(s.p_m)), sc_m(s.sc_m) { s.p_m = nullptr; }
+		shared_ptr(shared_ptr<U, Policy>&& s) noexcept : p_m(static_cast<T*>(s.p_m)), sc_m(move(s.sc_m)) { s.p_m = nullptr; }
 		template <class U>
-		shared_ptr(const weak_ptr<U>& w);
-		template<class U>
-		shared_ptr(unique_ptr<U>&& u) noexcept : p_m(static_cast<T*>(u.p_m)), sc_m(u.p_m, *u.dealloc_m) { u.p_m = u.dealloc_m = nullptr; }
+		shared_ptr(const weak_ptr<U, Policy>& w);
+		// unique_ptrのDeleterをそのまま参照カウンタへ移す
+		template <class U, class D>
+		shared_ptr(unique_ptr<U, D>&& u) : p_m(static_cast<T*>(u.get()))
+			, sc_m(static_cast<shared_count_impl<Policy>*>(new shared_count_deleter<U, D, Policy>(u.get(), move(u.get_deleter())))) { u.release(); }
 		template<class U>
 		explicit shared_ptr(U* p) : p_m(static_cast<T*>(p)), sc_m(p, dealloc_ident<dealloc::variable>()) {}
 		template<class U, size_t N, class... Types>
@@ -220,26 +430,24 @@ namespace iml {
 			return *this;
 		}
 		shared_ptr& operator=(shared_ptr&& s) noexcept {
-			sc_m = s.sc_m; p_m = s.p_m;
-			p_m = nullptr;
+			sc_m = move(s.sc_m); p_m = s.p_m;
+			s.p_m = nullptr;
 			return *this;
 		}
 		template <class U>
-		shared_ptr& operator=(const shared_ptr<U>& s) {
+		shared_ptr& operator=(const shared_ptr<U, Policy>& s) {
 			sc_m = s.sc_m; p_m = s.p_m;
 			return *this;
 		}
 		template <class U>
-		shared_ptr& operator=(shared_ptr<U>&& s) noexcept {
-			sc_m = s.sc_m; p_m = s.p_m;
+		shared_ptr& operator=(shared_ptr<U, Policy>&& s) noexcept {
+			sc_m = move(s.sc_m); p_m = s.p_m;
 			s.p_m = nullptr;
 			return *this;
 		}
-		template <class U>
-		shared_ptr& operator=(unique_ptr<U>&& u) noexcept {
-			shared_count(u.p_m, u.dealloc_m).swap(sc_m);
-			p_m = u.p_m;
-			u.p_m = u.dealloc_m = nullptr;
+		template <class U, class D>
+		shared_ptr& operator=(unique_ptr<U, D>&& u) {
+			shared_ptr(move(u)).swap(*this);
 			return *this;
 		}
 
@@ -262,28 +470,29 @@ namespace iml {
 namespace iml {
 
 	// ウィークカウンタ
+	template <class Policy>
 	class weak_count {
+		template <class>
 		friend class shared_count;
 
-		shared_count_impl* cnt_m;
+		shared_count_impl<Policy>* cnt_m;
 	public:
 		constexpr weak_count() : cnt_m(nullptr) {}
-		weak_count(const shared_count& s) : cnt_m(s.cnt_m) { if (cnt_m) cnt_m->weak_inc(); }
+		weak_count(const shared_count<Policy>& s) : cnt_m(s.cnt_m) { if (cnt_m) cnt_m->weak_inc(); }
 		weak_count(const weak_count& w) : cnt_m(w.cnt_m) { if (cnt_m) cnt_m->weak_inc(); }
 		weak_count(weak_count&& w) : cnt_m(w.cnt_m) { w.cnt_m = nullptr; }
 		~weak_count() { release(); }
 
 		// 弱参照とシェアカウントが0ならば解放
 		void release() {
-			if (cnt_m && !cnt_m->weak_dec() && !cnt_m->shared_count()) {
-				cnt_m->dealloc_m->dispose();
-				delete cnt_m;
+			if (cnt_m != nullptr) {
+				cnt_m->release_weak();
 				cnt_m = nullptr;
 			}
 		}
 
-		weak_count& operator=(const shared_count& s) {
-			shared_count_impl* temp = s.cnt_m;
+		weak_count& operator=(const shared_count<Policy>& s) {
+			shared_count_impl<Policy>* temp = s.cnt_m;
 			if (temp != cnt_m) {
 				if (temp != nullptr) temp->weak_inc();
 				release();
@@ -292,7 +501,7 @@ namespace iml {
 			return *this;
 		}
 		weak_count& operator=(const weak_count& w) {
-			shared_count_impl* temp = w.cnt_m;
+			shared_count_impl<Policy>* temp = w.cnt_m;
 			if (temp != cnt_m) {
 				if (temp) temp->weak_inc();
 				release();
@@ -302,6 +511,7 @@ namespace iml {
 		}
 		weak_count& operator=(weak_count&& w) {
 			if (w.cnt_m != cnt_m) {
+				release();
 				cnt_m = w.cnt_m;
 				w.cnt_m = nullptr;
 			}
@@ -314,29 +524,31 @@ namespace iml {
 		// 弱参照しているインスタンスのシェアが唯一か
 		bool unique() const { return use_count() == 1; }
 	};
-	// シャアカウンタのコンストラクタの記述
-	inline shared_count::shared_count(const weak_count& w) noexcept : cnt_m(w.cnt_m) { if (cnt_m) cnt_m->inc(); }
+	// シャアカウンタのコンストラクタの記述(既にシェアカウンタが0であれば空となる)
+	template <class Policy>
+	inline shared_count<Policy>::shared_count(const weak_count<Policy>& w) noexcept
+		: cnt_m(((w.cnt_m != nullptr) && w.cnt_m->inc_if_nonzero()) ? w.cnt_m : nullptr) {}
 
 	//shared_ptrの弱参照を保持して循環参照を解決するスマートポインタ
-	template <class T>
+	template <class T, class Policy>
 	class weak_ptr {
-		template <class>
+		template <class, class>
 		friend class weak_ptr;
-		template <class>
+		template <class, class>
 		friend class shared_ptr;
 
 		T*			p_m;		// 保持しているインスタンス
-		weak_count	wc_m;		// ウィークカウンタ
+		weak_count<Policy>	wc_m;		// ウィークカウンタ
 	public:
 		constexpr weak_ptr() noexcept : p_m(nullptr), wc_m() {}
 		weak_ptr(const weak_ptr& w) noexcept : p_m(w.p_m), wc_m(w.wc_m) {}
 		weak_ptr(const weak_ptr&& w) noexcept : p_m(w.p_m), wc_m(w.wc_m) { w.p_m = nullptr; }
 		template <class U>
-		weak_ptr(const weak_ptr<U>& w) noexcept : p_m(const_cast<T*>(static_cast<const T*>(w.p_m))), wc_m(w.wc_m) {}
+		weak_ptr(const weak_ptr<U, Policy>& w) noexcept : p_m(const_cast<T*>(static_cast<const T*>(w.p_m))), wc_m(w.wc_m) {}
 		template <class U>
-		weak_ptr(const weak_ptr<U>&& w) noexcept : p_m(const_cast<T*>(static_cast<const T*>(w.p_m))), wc_m(w.wc_m) { w.p_m = nullptr; }
+		weak_ptr(const weak_ptr<U, Policy>&& w) noexcept : p_m(const_cast<T*>(static_cast<const T*>(w.p_m))), wc_m(w.wc_m) { w.p_m = nullptr; }
 		template <class U>
-		weak_ptr(const shared_ptr<U>& s) noexcept : p_m(const_cast<T*>(static_cast<const T*>(s.p_m))), wc_m(s.sc_m) {}
+		weak_ptr(const shared_ptr<U, Policy>& s) noexcept : p_m(const_cast<T*>(static_cast<const T*>(s.p_m))), wc_m(s.sc_m) {}
 		~weak_ptr() {}
 
 		// スワップ
@@ -347,7 +559,7 @@ namespace iml {
 		void reset() { weak_ptr().swap(*this); }
 		void reset(const weak_ptr& w) { weak_ptr(w).swap(*this); }
 		// 監視しているリソースのインスタンスの取得
-		shared_ptr<T> lock() const { return shared_ptr<T>(*this); }
+		shared_ptr<T, Policy> lock() const { return shared_ptr<T, Policy>(*this); }
 
 		// 弱参照しているインスタンスのシェア数
 		size_t use_count() const { return wc_m.use_count(); }
@@ -356,7 +568,7 @@ namespace iml {
 
 		//代入演算
 		template <class U>
-		weak_ptr& operator=(const shared_ptr<U>& s) {
+		weak_ptr& operator=(const shared_ptr<U, Policy>& s) {
 			p_m = s.p_m; wc_m = s.sc_m;
 			return *this;
 		}
@@ -370,12 +582,12 @@ namespace iml {
 			return *this;
 		}
 		template <class U>
-		weak_ptr& operator=(const weak_ptr<U>& w) {
+		weak_ptr& operator=(const weak_ptr<U, Policy>& w) {
 			p_m = w.p_m; wc_m = w.wc_m;
 			return *this;
 		}
 		template <class U>
-		weak_ptr& operator=(weak_ptr<U>&& w) {
+		weak_ptr& operator=(weak_ptr<U, Policy>&& w) {
 			p_m = w.p_m; wc_m = w.wc_m;
 			w.p_m = nullptr;
 			return *this;
@@ -394,9 +606,27 @@ namespace iml {
 		const T& operator[](size_t index) const { return p_m[index]; }
 		T& operator[](size_t index) { return p_m[index]; }
 	};
-	template <class T>
+	// 既にリソースが破棄されていれば空となる
+	template <class T, class Policy>
 	template <class U>
-	inline shared_ptr<T>::shared_ptr(const weak_ptr<U>& w) : p_m(const_cast<T*>(static_cast<const T*>(w.p_m))), sc_m(w.wc_m) {}
+	inline shared_ptr<T, Policy>::shared_ptr(const weak_ptr<U, Policy>& w) : p_m(const_cast<T*>(static_cast<const T*>(w.p_m))), sc_m(w.wc_m) {
+		if (sc_m.use_count() == 0) p_m = nullptr;
+	}
+
+
+	// 参照カウンタとインスタンスを1度の確保で構築したshared_ptrの生成
+	template <class T, class Policy, class Allocator, class... Types>
+	inline shared_ptr<T, Policy> allocate_shared(const Allocator& alloc, Types&&... args) {
+		auto c = shared_count_inplace<T, Allocator, Policy>::create(alloc, forward<Types>(args)...);
+		shared_ptr<T, Policy> temp;
+		temp.p_m = c->get();
+		shared_count<Policy>(static_cast<shared_count_impl<Policy>*>(c)).swap(temp.sc_m);
+		return temp;
+	}
+	template <class T, class Policy = atomic_count_policy, class... Types>
+	inline shared_ptr<T, Policy> make_shared(Types&&... args) {
+		return allocate_shared<T, Policy>(allocator<T>(), forward<Types>(args)...);
+	}
 }
 
 #endif
\ No newline at end of file